@@ -29,12 +29,19 @@ namespace fluke {
         virtual Agent* clone() const = 0;
         /// Copy an agent.
         virtual void copy( const Agent & );
+        /// Dispose of a dead agent. By default it is deleted, pooled agents
+        /// go back to their pool instead.
+        virtual void toPool();
         
         /// Initialise the agent.
         virtual void initialise() = 0;
         /// Perform all actions of a timestep. The method needs to be
         /// overriden in child classes to obtain more interesting behaviour.
         virtual void step( Population & ) = 0;
+        /// Chance that \c step kills the agent. The event driven update of
+        /// the population uses it as rate of death instead of calling
+        /// \c step.
+        virtual double mortality() const = 0;
         /// Create a sibling. The \c fluke equivalent of reproduction.
         virtual Agent* sibling() = 0;
         
@@ -63,6 +70,14 @@ namespace fluke {
         
         /// Get its (genotypical) distance.
         virtual int distance() const = 0;
+        /// Get number of bytes held by the agent (not by its genome).
+        virtual std::size_t bytes() const = 0;
+        
+        /// Set the slot of the agent in the index of a grid plane.
+        void slot( int, int );
+        /// Get the slot of the agent in the index of a grid plane (-1 if
+        /// not present).
+        int slot( int ) const;
             
         protected:
         /// Hidden constructor.
@@ -75,14 +90,16 @@ namespace fluke {
         Agent( const Agent & );
             
         protected:
-        /// Ready to be erased from the population (flag).
-        bool dying_;
-        /// My ID-tag.
-        AgentTag me_;
-        /// Parent's ID-tag.
-        AgentTag ancestor_;
+        /// My ID-tag, packed (see \c AgentTag::pack).
+        boost::uint64_t me_;
+        /// Parent's ID-tag, packed.
+        boost::uint64_t ancestor_;
         /// Type (competition experiments).
         int type_;
+        /// Slots in the agent index of both grid planes.
+        int slot_[ 2 ];
+        /// Ready to be erased from the population (flag).
+        bool dying_;
     };
 
     /// Overloaded \c << operator for easy writing to streams (xml)
@@ -94,22 +111,28 @@ namespace fluke {
     { return dying_; }
 
     inline void Agent::parentTag( AgentTag t )
-    { ancestor_ = t; }
+    { ancestor_ = t.pack(); }
     
     inline AgentTag Agent::parentTag() const
-    { return ancestor_; }
+    { return AgentTag::unpack( ancestor_ ); }
 
     inline void Agent::myTag( AgentTag t )
-    { me_ = t; }
+    { me_ = t.pack(); }
     
     inline AgentTag Agent::myTag() const
-    { return me_; }
+    { return AgentTag::unpack( me_ ); }
     
     inline void Agent::type( int t )
     { type_ = t; }
     
     inline int Agent::type() const
     { return type_; }
+
+    inline void Agent::slot( int p, int s )
+    { slot_[ p ] = s; }
+
+    inline int Agent::slot( int p ) const
+    { return slot_[ p ]; }
 }
 #endif
 
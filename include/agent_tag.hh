@@ -26,6 +26,10 @@ namespace fluke {
         
         /// As a string
         std::string str() const;
+        /// Packed into 64 bits (lineage id), see \c unpack
+        boost::uint64_t pack() const;
+        /// Unpack a lineage id
+        static AgentTag unpack( boost::uint64_t );
 
         public:        
         /// Time of birth
@@ -37,12 +41,45 @@ namespace fluke {
         /// index for those agents that are born in the same timestep as their
         /// parent
         int i;
+
+        private:
+        /// Bits of the fields in a lineage id (16M timesteps, grids of 4K
+        /// squared, 64K births in a cascade). Every field is stored plus
+        /// one, such that -1 (unset) fits.
+        static const int TIME_BITS = 24;
+        static const int XY_BITS = 12;
+        static const int I_BITS = 16;
     };
     
     inline bool operator==( const AgentTag &t1, const AgentTag &t2 ) 
     { return t1.time == t2.time && t1.x == t2.x 
         && t1.y == t2.y && t1.i == t2.i; }
     
+    inline boost::uint64_t AgentTag::pack() const {
+        // a clipped field would give two agents the same tag
+        if( time < -1 || time + 1 >= ( 1L << TIME_BITS ) ||
+            x < -1 || x + 1 >= ( 1 << XY_BITS ) ||
+            y < -1 || y + 1 >= ( 1 << XY_BITS ) ||
+            i < -1 || i + 1 >= ( 1 << I_BITS ) ) {
+            throw "Agent tag does not fit in a lineage id.";
+        }
+        boost::uint64_t aux = i + 1;
+        aux |= static_cast< boost::uint64_t >( y + 1 ) << I_BITS;
+        aux |= static_cast< boost::uint64_t >( x + 1 ) << ( XY_BITS + I_BITS );
+        aux |= static_cast< boost::uint64_t >( time + 1 ) 
+            << ( 2 * XY_BITS + I_BITS );
+        return aux;
+    }
+
+    inline AgentTag AgentTag::unpack( boost::uint64_t p ) {
+        const boost::uint64_t xy_mask = ( 1 << XY_BITS ) - 1;
+        const boost::uint64_t i_mask = ( 1 << I_BITS ) - 1;
+        return AgentTag( static_cast< long >( p >> ( 2 * XY_BITS + I_BITS ) )
+            - 1, static_cast< int >( ( p >> ( XY_BITS + I_BITS ) ) & xy_mask )
+            - 1, static_cast< int >( ( p >> I_BITS ) & xy_mask ) - 1, 
+            static_cast< int >( p & i_mask ) - 1 );
+    }
+
     inline std::string AgentTag::str() const
     { return boost::lexical_cast< std::string >( time ) + "-" +
         boost::lexical_cast< std::string >( x ) + "-" +
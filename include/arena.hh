@@ -0,0 +1,313 @@
+//
+// Scratch memory for the temporaries of a generation.
+//
+// by Anton Crombach, A.B.M.Crombach@bio.uu.nl
+//
+
+#ifndef _FLUKE_ARENA_H_
+#define _FLUKE_ARENA_H_
+
+#include "defs.hh"
+
+namespace fluke {
+
+    /// \class ScratchArena
+    /// \brief Bump-pointer memory for short-lived containers.
+    ///
+    /// Every thread allocates from an arena of its own by moving a pointer
+    /// through a list of blocks, freeing is a no-op. A unit of work (the
+    /// mutation of a genome, counting its genes) opens a \c ScratchScope,
+    /// which rewinds the arena to where it was when the work is done. The
+    /// blocks are kept, so the temporaries of mutation and recombination
+    /// do not touch the heap in the long run, and the arena never holds
+    /// more than the largest unit of work needs. Hence, scratch containers
+    /// must not outlive the scope that made them.
+    ///
+    /// Arenas of finished threads are kept for the next ones.
+    class ScratchArena {
+        public:
+        /// Constructor
+        ScratchArena();
+        /// Destructor
+        ~ScratchArena();
+
+        /// Get n bytes, aligned for any type
+        void* allocate( std::size_t );
+        /// Rewind to the first block
+        void reset();
+        /// Get number of bytes held in blocks
+        std::size_t capacity() const;
+        /// Get number of bytes handed out since the last reset
+        std::size_t used() const;
+
+        /// Position in an arena, see \c rewind
+        struct mark {
+            uint block;
+            char *top, *end;
+            std::size_t used;
+        };
+        /// Get the current position
+        mark position() const;
+        /// Go back to an earlier position, everything handed out since is
+        /// free again
+        void rewind( const mark & );
+
+        public:
+        /// Get the arena of the calling thread
+        static ScratchArena & local();
+        /// Rewind all arenas, a safety net for scratch used outside any
+        /// scope. Only call when no thread uses them.
+        static void resetAll();
+        /// Get number of bytes held by all arenas
+        static std::size_t totalCapacity();
+
+        private:
+        ScratchArena( const ScratchArena & );
+        ScratchArena & operator=( const ScratchArena & );
+
+        void nextBlock( std::size_t );
+        static void retire( ScratchArena * );
+        static boost::thread_specific_ptr< ScratchArena > & tss();
+        static std::vector< ScratchArena* > & arenas();
+        static std::vector< ScratchArena* > & spares();
+        static boost::mutex & mutex();
+
+        private:
+        /// Size of a block, larger requests get a block of their own
+        static const std::size_t BLOCK = 1 << 16;
+        /// Alignment of the requests
+        static const std::size_t ALIGN = 16;
+
+        std::vector< std::pair< char*, std::size_t > > blocks_;
+        uint current_;
+        char *top_, *end_;
+        std::size_t used_;
+    };
+
+    inline ScratchArena::ScratchArena()
+        : blocks_(), current_( 0 ), top_( 0 ), end_( 0 ), used_( 0 ) {}
+
+    inline ScratchArena::~ScratchArena() {
+        for( uint i = 0; i != blocks_.size(); ++i ) {
+            delete [] blocks_[ i ].first;
+        }
+    }
+
+    inline void* ScratchArena::allocate( std::size_t n ) {
+        n = ( n + ALIGN - 1 ) & ~( ALIGN - 1 );
+        if( static_cast< std::size_t >( end_ - top_ ) < n ) {
+            nextBlock( n );
+        }
+        void *result = top_;
+        top_ += n;
+        used_ += n;
+        return result;
+    }
+
+    inline void ScratchArena::nextBlock( std::size_t n ) {
+        // take the next block if it is large enough, else put in a new one
+        if( !blocks_.empty() ) {
+            ++current_;
+        }
+        if( current_ == blocks_.size() || blocks_[ current_ ].second < n ) {
+            std::size_t aux = n > BLOCK ? n : BLOCK;
+            blocks_.insert( blocks_.begin() + current_,
+                std::make_pair( new char[ aux ], aux ) );
+        }
+        top_ = blocks_[ current_ ].first;
+        end_ = top_ + blocks_[ current_ ].second;
+    }
+
+    inline void ScratchArena::reset() {
+        current_ = 0;
+        used_ = 0;
+        if( !blocks_.empty() ) {
+            top_ = blocks_[ 0 ].first;
+            end_ = top_ + blocks_[ 0 ].second;
+        }
+    }
+
+    inline ScratchArena::mark ScratchArena::position() const {
+        mark result;
+        result.block = current_;
+        result.top = top_;
+        result.end = end_;
+        result.used = used_;
+        return result;
+    }
+
+    inline void ScratchArena::rewind( const mark &m ) {
+        if( m.top == 0 ) {
+            // no block yet when the mark was taken
+            reset();
+        } else {
+            // blocks added since were inserted behind the marked one
+            current_ = m.block;
+            top_ = m.top;
+            end_ = m.end;
+            used_ = m.used;
+        }
+    }
+
+    inline std::size_t ScratchArena::capacity() const {
+        std::size_t result = 0;
+        for( uint i = 0; i != blocks_.size(); ++i ) {
+            result += blocks_[ i ].second;
+        }
+        return result;
+    }
+
+    inline std::size_t ScratchArena::used() const
+    { return used_; }
+
+    inline ScratchArena & ScratchArena::local() {
+        ScratchArena *result = tss().get();
+        if( result == 0 ) {
+            boost::mutex::scoped_lock lock( mutex() );
+            if( spares().empty() ) {
+                result = new ScratchArena();
+                arenas().push_back( result );
+            } else {
+                result = spares().back();
+                spares().pop_back();
+            }
+            tss().reset( result );
+        }
+        return *result;
+    }
+
+    inline void ScratchArena::resetAll() {
+        boost::mutex::scoped_lock lock( mutex() );
+        for( std::vector< ScratchArena* >::iterator i = arenas().begin();
+            i != arenas().end(); ++i ) {
+            ( **i ).reset();
+        }
+    }
+
+    inline std::size_t ScratchArena::totalCapacity() {
+        boost::mutex::scoped_lock lock( mutex() );
+        std::size_t result = 0;
+        for( std::vector< ScratchArena* >::iterator i = arenas().begin();
+            i != arenas().end(); ++i ) {
+            result += ( **i ).capacity();
+        }
+        return result;
+    }
+
+    inline void ScratchArena::retire( ScratchArena *a ) {
+        boost::mutex::scoped_lock lock( mutex() );
+        spares().push_back( a );
+    }
+
+    // the bookkeeping is never destroyed, threads may retire their arena
+    // while the program shuts down
+    inline boost::thread_specific_ptr< ScratchArena > & ScratchArena::tss() {
+        static boost::thread_specific_ptr< ScratchArena > *result =
+            new boost::thread_specific_ptr< ScratchArena >(
+                &ScratchArena::retire );
+        return *result;
+    }
+
+    inline std::vector< ScratchArena* > & ScratchArena::arenas() {
+        static std::vector< ScratchArena* > *result =
+            new std::vector< ScratchArena* >();
+        return *result;
+    }
+
+    inline std::vector< ScratchArena* > & ScratchArena::spares() {
+        static std::vector< ScratchArena* > *result =
+            new std::vector< ScratchArena* >();
+        return *result;
+    }
+
+    inline boost::mutex & ScratchArena::mutex() {
+        static boost::mutex *result = new boost::mutex();
+        return *result;
+    }
+
+
+    /// \class ScratchScope
+    /// \brief Rewinds the arena of the calling thread when it goes out of
+    /// scope.
+    ///
+    /// Declare it before the scratch containers, such that they are gone
+    /// before the arena is rewound. Scopes nest.
+    class ScratchScope {
+        public:
+        /// Constructor, marks the arena of the calling thread
+        ScratchScope() 
+            : arena_( ScratchArena::local() ), mark_( arena_.position() ) {}
+        /// Destructor, rewinds the arena to the mark
+        ~ScratchScope()
+        { arena_.rewind( mark_ ); }
+
+        private:
+        ScratchScope( const ScratchScope & );
+        ScratchScope & operator=( const ScratchScope & );
+
+        private:
+        ScratchArena &arena_;
+        ScratchArena::mark mark_;
+    };
+
+
+    /// \class ScratchAllocator
+    /// \brief Standard allocator on the scratch arena of the calling thread.
+    ///
+    /// Deallocation does nothing, the memory comes back when the enclosing
+    /// \c ScratchScope ends.
+    template< class T >
+    class ScratchAllocator {
+        public:
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+
+        template< class U > struct rebind
+        { typedef ScratchAllocator< U > other; };
+
+        public:
+        ScratchAllocator() {}
+        template< class U > ScratchAllocator( const ScratchAllocator< U > & ) {}
+
+        pointer address( reference x ) const
+        { return &x; }
+        const_pointer address( const_reference x ) const
+        { return &x; }
+
+        pointer allocate( size_type n, const void * = 0 ) {
+            return static_cast< pointer >(
+                ScratchArena::local().allocate( n * sizeof( T ) ) );
+        }
+        void deallocate( pointer, size_type ) {}
+
+        size_type max_size() const
+        { return static_cast< size_type >( -1 ) / sizeof( T ); }
+
+        void construct( pointer p, const T &t )
+        { new( p ) T( t ); }
+        void destroy( pointer p )
+        { p->~T(); }
+    };
+
+    template< class T, class U >
+    inline bool operator==( const ScratchAllocator< T > &,
+        const ScratchAllocator< U > & )
+    { return true; }
+
+    template< class T, class U >
+    inline bool operator!=( const ScratchAllocator< T > &,
+        const ScratchAllocator< U > & )
+    { return false; }
+
+    /// Vector on the scratch arena
+    template< class T >
+    struct scratch_vector {
+        typedef std::vector< T, ScratchAllocator< T > > type;
+    };
+}
+#endif
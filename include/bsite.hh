@@ -37,6 +37,10 @@ namespace fluke {
         virtual void copy( const ChromosomeElement & );
         /// Return to pool.
         virtual void toPool();
+        /// Take memory from the slabs of the pool
+        static void* operator new( std::size_t );
+        /// Give memory back to the slabs of the pool
+        static void operator delete( void *, std::size_t );
         
         /// Point mutate the short sequence
         virtual int mutate();
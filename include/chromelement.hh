@@ -15,8 +15,14 @@ namespace fluke {
     /// \brief Abstract element of a chromosome.
     ///
     /// In \c fluke chromosomes consist of \em atoms, called chromosome 
-    /// elements. 
+    /// elements. Every element carries the kind of its concrete class, such
+    /// that chromosome scans can switch on it instead of using RTTI.
     class ChromosomeElement : public CachedElement {
+        public:
+        /// Kinds of elements, one per concrete class.
+        enum ce_kind { BINDING_SITE, ORDINARY_DSTREAM, MODULE_DSTREAM, 
+            TRANSCRIPTION_FACTOR, RETROPOSON, REPEAT, CENTROMERE };
+        
         public:
         /// Virtual destructor.
         virtual ~ChromosomeElement() {};
@@ -34,6 +40,8 @@ namespace fluke {
         void activate();
         /// Is the element \em activated?
         bool isActive() const;
+        /// Get the kind of element.
+        ce_kind kind() const;
         
         /// Write to an output stream.
         void write( std::ostream & ) const;
@@ -43,15 +51,20 @@ namespace fluke {
         virtual std::string asString() const = 0;
 
         protected:
-        /// Hidden constructor.
-        ChromosomeElement() : CachedElement(), active_( true ) {};
+        /// Hidden constructor with the kind of the concrete class.
+        explicit ChromosomeElement( ce_kind k ) 
+        : CachedElement(), kind_( k ), active_( true ) {};
         /// Hidden copy constructor.
         explicit ChromosomeElement( const ChromosomeElement &ce ) 
-        : CachedElement(), active_( ce.active_ ) {};
+        : CachedElement(), kind_( ce.kind_ ), active_( ce.active_ ) {};
 
         private:
+        /// Kind of element, fixed at construction. The flags are packed
+        /// into the bytes behind the vtable pointer, such that the fields
+        /// of the concrete classes follow directly.
+        unsigned int kind_ : 3;
         /// Flag signalling if the element is active.
-        bool active_;
+        unsigned int active_ : 1;
     };
 
     /// Overloaded \c << operator for easy writing to streams.
@@ -68,6 +81,9 @@ namespace fluke {
     inline bool ChromosomeElement::isActive() const
     { return active_; }
 
+    inline ChromosomeElement::ce_kind ChromosomeElement::kind() const
+    { return static_cast< ce_kind >( kind_ ); }
+
     inline void ChromosomeElement::write( std::ostream &os ) const 
     { os << asXmlString(); }
 }
@@ -8,6 +8,8 @@
 #define _FLUKE_CHROMOSOME_H_
 
 #include "defs.hh"
+#include "rope.hh"
+#include "arena.hh"
 #include "chromelement.hh"
 #include "genome.hh"
 #include "bsite.hh"
@@ -36,6 +38,18 @@ namespace fluke {
     /// deleted, retrotransposons copy within the chromosome... FIX
     ///
     /// From this sequence, a transcription network can be built.
+    ///
+    /// The elements are kept in one contiguous buffer of pointers, so a 
+    /// traversal streams through memory. Insertions and erasures move the
+    /// tail of the buffer and invalidate the iterators behind them. For very
+    /// large genomes the buffer is a Rope instead (see ce_sequence), then 
+    /// they only move the tail of a chunk, and the positions of breaks and
+    /// insertion targets are kept in a PositionSet.
+    ///
+    /// Copies share the buffer (and the elements in it) until one of them
+    /// is about to change it, only then the elements are cloned (copy on
+    /// write). Most daughters never mutate, so a clonal population holds
+    /// little more than a single genome.
     class Chromosome : public CachedElement {
         friend class FixedMutateRates;
         friend class LinearMutateRates;
@@ -47,37 +61,55 @@ namespace fluke {
         static const uint NR_RATES = 12;
         
         public:
+        /// Chromosome element buffer
+        typedef ce_sequence ce_container;
         /// Chromosome iterator
-        typedef std::list< ChromosomeElement* >::iterator ce_iter;
+        typedef ce_container::iterator ce_iter;
         /// Chromosome const iterator
-        typedef std::list< ChromosomeElement* >::const_iterator 
-            const_ce_iter;
+        typedef ce_container::const_iterator const_ce_iter;
         /// Chromosome reverse iterator
-        typedef std::list< ChromosomeElement* >::reverse_iterator ce_riter;
+        typedef ce_container::reverse_iterator ce_riter;
         /// Chromosome const reverse iterator
-        typedef std::list< ChromosomeElement* >::const_reverse_iterator 
-            const_ce_riter;
+        typedef ce_container::const_reverse_iterator const_ce_riter;
+        /// Chromosome element buffer shared by copies
+        typedef boost::shared_ptr< ce_container > shared_container;
+        /// Population-wide table of interned buffers, keyed by content hash.
+        /// The table holds on to its buffers, so they are never written to.
+        typedef std::multimap< std::size_t, shared_container > intern_table;
         /// Chromosome tag list/vector/map
         typedef std::vector< uint > tag_container;
         /// Chromosome tag list/vector/map iterator
         typedef tag_container::iterator tag_iter;
+        /// Gene key: module of the downstream (-1 if ordinary) and its tag
+        typedef std::pair< int, uint > gene_key;
+        /// Copy numbers of the genes, sorted on key
+        typedef std::vector< std::pair< gene_key, uint > > gene_counts;
+        /// Copy numbers on the scratch arena
+        typedef scratch_vector< std::pair< gene_key, uint > >::type 
+            gene_scratch;
+        /// Chromosome elements on the scratch arena
+        typedef scratch_vector< ChromosomeElement* >::type ce_scratch;
 
         public:
         /// Constructor
         Chromosome();
-        /// Constructor, the list is not copied. Memory responsabilities
-        /// are moved to \c this.
+        /// Constructor, the elements are moved out of the list and the list
+        /// is deleted. Memory responsabilities are moved to \c this.
         Chromosome( Genome *, std::list< ChromosomeElement* > * );
         /// Copy constructor
         explicit Chromosome( const Chromosome & );
         /// Destructor
         ~Chromosome();
-        /// Copy a chromosome into \c this
+        /// Copy a chromosome into \c this, sharing its elements
         void copy( const Chromosome & );
         /// Clone a chromosome
         Chromosome* clone() const;
         /// Back to the pool
         virtual void toPool();
+        /// Take memory from the slabs of the pool
+        static void* operator new( std::size_t );
+        /// Give memory back to the slabs of the pool
+        static void operator delete( void *, std::size_t );
 
         /// All the mutations that can be handled within the chromosome
         /// are performed by invoking this method.
@@ -101,18 +133,24 @@ namespace fluke {
         /// Retrotransposons may arise newly at rare occasions.
         void newRetrotransposon();
         
-        /// Return an iterator to a random element in this chromosome
+        /// Return an iterator to a random element in this chromosome, that 
+        /// is a valid place to insert (no retroposon, centromere or repeat 
+        /// directly behind a retroposon)
         boost::tuple< Chromosome*, ce_iter > randChromosomeElement();
         /// Return an iterator to a random element in the genome
         boost::tuple< Chromosome*, ce_iter > randGenomeElement();
-        /// Return all the segments
-        std::list< Chromosome* > segments();
+        /// Cut at the double strand breaks and add the segments to the 
+        /// vector (\c this itself, if there were no breaks)
+        void segments( Genome::chromos_scratch & );
         /// Append a chromosome to the end of \c this
         void append( Chromosome* );
         
         /// Reset the state of all chromosome elements. It should be 
         /// performed before a new simulation update on a genome
         void reset();
+        /// Activate the elements left inactive by a mutation pass. After
+        /// the pass of the whole genome, the buffer is still ours alone.
+        void activate();
         /// Empty the chromosome, the chromosome elements are not freed
         void clear();
         /// Make sure all flags of caching behaviour are set to update cache
@@ -124,12 +162,18 @@ namespace fluke {
         Genome* parent() const;
 
         /// Get a reference to the contents of the chromosome
-        const std::list< ChromosomeElement* > & elements() const;
+        const ce_container & elements() const;
+        /// Get number of bytes held by the chromosome, its element buffer
+        /// excluded (see \c bufferBytes)
+        std::size_t bytes() const;
 
         /// Get the downstream tags present in the chromosome
         tag_container essentialTags() const;
         /// Get the downstream tags of a module
         tag_container moduleTags( int ) const;
+        /// Get the copy numbers of ordinary and module downstreams, kept up
+        /// to date by the mutations
+        const gene_counts & geneCounts() const;
         
         /// Get nr retroposons
         int nrRetroposons() const;
@@ -138,7 +182,7 @@ namespace fluke {
         /// Get nr of dsbs
         int nrDoubleStrandBreaks() const;
         /// Get nr of gene cp/rm
-        tag_container nrMutations() const;
+        const tag_container & nrMutations() const;
         /// Get the size of the chromosome (number of elements)
         int size() const;
         /// Is the chromosome empty?
@@ -210,10 +254,30 @@ namespace fluke {
         void mutationRate( double );
         /// Get mutation rate of rates
         double mutationRate() const;
+        /// Set if mutations are sampled by skipping ahead to the next event
+        /// instead of drawing for every element
+        void skipAhead( bool );
+        /// Are mutations sampled by skipping ahead?
+        bool skipAhead() const;
 
         public:
         /// Set mutational scheme
         static void mutationScheme( MutateRates* );
+        /// Set if chromosomes with equal content share one buffer
+        static void interning( bool );
+        /// Are chromosomes interned?
+        static bool interning();
+        /// Get the nr of buffers in the intern table
+        static uint nrInterned();
+        /// Get number of bytes held by a buffer and its elements
+        static std::size_t bufferBytes( const ce_container & );
+        
+        public:
+        /// Returns the elements of a buffer to their pools, once the last
+        /// chromosome sharing it lets go
+        struct ReturnElements {
+            void operator()( ce_container * ) const;
+        };
         
         public:
         class IsRetroposon : 
@@ -221,17 +285,23 @@ namespace fluke {
             public:
             IsRetroposon() {}
             bool operator()( ChromosomeElement *ce ) const
-            { return typeid( *ce ) == typeid( Retroposon ); }
+            { return ce->kind() == ChromosomeElement::RETROPOSON; }
         };
         
         class IsTrueDstream : 
             public std::unary_function< ChromosomeElement*, bool > {
             public:
             IsTrueDstream() {}
-            bool operator()( ChromosomeElement *ce ) const
-            { return typeid( *ce ) == typeid( TranscriptionFactor ) or
-                     typeid( *ce ) == typeid( OrdinaryDownstream ) or
-                     typeid( *ce ) == typeid( ModuleDownstream ); }
+            bool operator()( ChromosomeElement *ce ) const {
+                switch( ce->kind() ) {
+                    case ChromosomeElement::TRANSCRIPTION_FACTOR:
+                    case ChromosomeElement::ORDINARY_DSTREAM:
+                    case ChromosomeElement::MODULE_DSTREAM:
+                        return true;
+                    default:
+                        return false;
+                }
+            }
         };
         
         class IsBindingSite : 
@@ -239,7 +309,7 @@ namespace fluke {
             public:
             IsBindingSite() {}
             bool operator()( ChromosomeElement *ce ) const
-            { return typeid( *ce ) == typeid( BindingSite ); }
+            { return ce->kind() == ChromosomeElement::BINDING_SITE; }
         };
         
         class IsRepeat :
@@ -247,7 +317,7 @@ namespace fluke {
             public:
             IsRepeat() {}
             bool operator()( ChromosomeElement *ce ) const
-            { return typeid( *ce ) == typeid( Repeat ); }
+            { return ce->kind() == ChromosomeElement::REPEAT; }
         };
         
         class IsDoubleStrandBreak :
@@ -255,12 +325,8 @@ namespace fluke {
             public:
             IsDoubleStrandBreak() {}
             bool operator()( ChromosomeElement *ce ) const {
-                Repeat *aux = dynamic_cast< Repeat* >( ce );
-                if( aux ) {
-                    return aux->hasDSB();
-                } else {
-                    return false;
-                }
+                return ce->kind() == ChromosomeElement::REPEAT &&
+                    static_cast< Repeat* >( ce )->hasDSB();
             }
         };
 
@@ -269,23 +335,78 @@ namespace fluke {
             public:
             IsCentromere() {}
             bool operator()( ChromosomeElement *ce ) const
-            { return typeid( *ce ) == typeid( Centromere ); }
+            { return ce->kind() == ChromosomeElement::CENTROMERE; }
         };
         
+        public:
+        /// Share the buffer with an equal chromosome elsewhere in the 
+        /// population, or offer it to later ones
+        void intern();
+        
         private:
+        // copy on write: make sure the buffer is not shared with others
+        void own();
+        // an empty buffer, recycled together with its shared count
+        static shared_container newBuffer();
+        // structural hash and equality of elements, ignoring activity
+        static std::size_t elementHash( const ChromosomeElement * );
+        static bool sameElement( const ChromosomeElement *, 
+            const ChromosomeElement * );
+        static std::size_t contentHash( const ce_container & );
+        static bool sameContent( const ce_container &, const ce_container & );
+        ce_iter own( ce_iter );
+        // the mutation events, given a uniform draw below the total rate
+        ce_iter geneMutate( ce_iter, double );
+        ce_iter retroposonMutate( ce_iter, double );
+        ce_iter repeatMutate( ce_iter, double );
+        // draw for every active element if it has an event
+        void elementMutate();
+        // visit only the elements that have an event (geometric gaps)
+        void skipAheadMutate();
+        // nr of elements without event before the next one
+        int skipLength( double ) const;
         ce_iter upstreamSelect( ce_iter );
-        int nrRetroposons( ce_iter, ce_iter ) const;
+        int nrRetroposons( const_ce_iter, const_ce_iter ) const;
+        // bookkeeping of gene copy numbers
+        void countGene( const ChromosomeElement *, int );
+        void countGene( const gene_key &, int );
+        void recountGenes();
+        // keep the positions of breaks and targets in step with the buffer
+        void elementsInserted( uint, uint );
+        void elementsErased( uint, uint );
+        void recordBreak( uint );
+        void forgetBreak( uint );
+        Chromosome* piece( ce_iter );
+        // index of valid insertion targets
+        bool isTarget( uint ) const;
+        void targetsInserted( uint, uint );
+        void targetsErased( uint, uint );
+        void recheckTarget( uint );
+        void rebuildTargets();
         void copyRates( const Chromosome &, Chromosome & ) const;
         // overloading list methods coz of length caching; insert, splice
         ce_iter insert( ce_iter, ChromosomeElement* );
-        void splice( ce_iter, std::list< ChromosomeElement* >, uint, uint );
+        void splice( ce_iter, const ce_scratch &, uint, uint );
         
         private:
         Genome *parent_;
-        std::list< ChromosomeElement* > *chro_;
+        shared_container chro_;
         std::vector< uint > mut_events_;
+        gene_counts genes_;
         mutable uint nr_retroposons_, nr_ltr_, len_;
         mutable bool update_retro_, update_ltr_, update_len_;
+        // positions of the repeats with a double strand break, ascending
+        ce_positions dsbs_;
+        // positions of the valid insertion targets, ascending
+        ce_positions targets_;
+        bool update_targets_;
+        // buffer is in the intern table, under hash_
+        bool interned_;
+        // mutations are sampled by skipping ahead
+        bool skip_ahead_;
+        // elements were inactivated since the last activate()
+        bool inactive_;
+        std::size_t hash_;
             
         // mutation rates 
         double cp_tp_rate_;
@@ -311,6 +432,10 @@ namespace fluke {
         
         private:
         static MutateRates *rate_mutator_;
+        static bool interning_;
+        static intern_table interned_buffers_;
+        static std::size_t intern_sweep_;
+        static boost::mutex intern_mutex_;
     };
 
     /// Overloaded \c << operator for easy writing to streams.
@@ -327,20 +452,20 @@ namespace fluke {
     Chromosome::randGenomeElement()
     { return parent_->randElement(); }
 
-    inline const std::list< ChromosomeElement* >& Chromosome::elements() const
+    inline const Chromosome::ce_container& Chromosome::elements() const
     { return *chro_; }
 
     inline int Chromosome::nrDoubleStrandBreaks() const 
     { return mut_events_[ DSB ]; }
 
-    inline std::vector< uint > Chromosome::nrMutations() const
+    inline const Chromosome::gene_counts & Chromosome::geneCounts() const
+    { return genes_; }
+
+    inline const std::vector< uint > & Chromosome::nrMutations() const
     { return mut_events_; }
     
     inline bool Chromosome::empty() const 
     { return chro_->empty(); }
-    
-    inline void Chromosome::clear()
-    { chro_->clear(); }
 }
 #endif
 
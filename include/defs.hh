@@ -10,6 +10,7 @@
 #include <unistd.h>
 
 #include <map>
+#include <set>
 #include <list>
 #include <cmath>
 #include <string>
@@ -34,6 +35,17 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/program_options.hpp>
 #include <boost/tuple/tuple.hpp>
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/pool/pool_alloc.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <boost/thread/tss.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/once.hpp>
+#include <boost/thread/thread.hpp>
 
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem/operations.hpp>
@@ -152,6 +164,7 @@ namespace fluke {
     class LogObserver;
     class AsyncLogObserver;
     class Subject;
+    class ObservedSubject;
 
     class LogCsvMutations;
     class LogCsvGenes;
@@ -175,13 +188,67 @@ namespace fluke {
     class Config;
     class Fluke;
 
+    /// \class UniformStream
+    /// \brief Uniform random numbers [0,1) with optional per-thread streams.
+    ///
+    /// Behaves exactly like a plain \c uniform_gen_type, unless it is put in
+    /// parallel mode and the calling thread has bound a stream of its own.
+    /// The tiled update of the population binds one stream per tile, such
+    /// that a run does not depend on the number of worker threads.
+    class UniformStream {
+        public:
+        /// Constructor, the generator is copied.
+        explicit UniformStream( base_generator_type & );
+        /// Draw a number from the stream bound to this thread.
+        double operator()();
+        /// Replace the main stream (reseeding).
+        UniformStream& operator=( const uniform_gen_type & );
+        /// Bind a stream to the calling thread (0 unbinds).
+        void bind( uniform_gen_type * );
+        /// Set whether bound streams are looked up at all.
+        void parallel( bool );
+        /// Are bound streams looked up (threads may be running)?
+        bool parallel() const;
+        
+        private:
+        static void unbound( uniform_gen_type * ) {}
+        
+        private:
+        uniform_gen_type main_;
+        boost::thread_specific_ptr< uniform_gen_type > local_;
+        bool parallel_;
+    };
+    
+    inline UniformStream::UniformStream( base_generator_type &g )
+        : main_( g ), local_( &UniformStream::unbound ), parallel_( false ) {}
+
+    inline double UniformStream::operator()() {
+        if( parallel_ ) {
+            uniform_gen_type *aux = local_.get();
+            if( aux != 0 ) return ( *aux )();
+        }
+        return main_();
+    }
+
+    inline UniformStream& UniformStream::operator=( const uniform_gen_type &u )
+    { main_ = u; return *this; }
+
+    inline void UniformStream::bind( uniform_gen_type *u )
+    { local_.reset( u ); }
+
+    inline void UniformStream::parallel( bool p )
+    { parallel_ = p; }
+
+    inline bool UniformStream::parallel() const
+    { return parallel_; }
+
     /// Random number generator. It is a global object as it is used 
     /// throughout the entire program. It needs to be used in conjunction
     /// with a distribution.
     extern base_generator_type generator;
     /// Uniform random numbers [0,1). It is a global object to provide easy
     /// access in the entire program.
-    extern uniform_gen_type uniform;
+    extern UniformStream uniform;
 
     /// Generate random number of type T from the interval \f$[0,n)\f$.
     template< class T > T
@@ -34,9 +34,11 @@ namespace fluke {
             
         protected:
             /// Hidden constructor.
-            Downstream() : ChromosomeElement(), tag_( 0 ) {};
+            explicit Downstream( ce_kind k ) 
+                : ChromosomeElement( k ), tag_( 0 ) {};
             /// Hidden constructor with tag
-            Downstream( uint t ) : ChromosomeElement(), tag_( t ) {};
+            Downstream( ce_kind k, uint t ) 
+                : ChromosomeElement( k ), tag_( t ) {};
             /// Hidden copy constructor.
             Downstream( const Downstream &ds ) 
                 : ChromosomeElement( ds ), tag_( ds.tag_ ) {};
@@ -53,6 +55,6 @@ namespace fluke {
     { return tag_; }
     
     inline void Downstream::copy( const ChromosomeElement &ce ) 
-    { tag_ = dynamic_cast< const Downstream* >( &ce )->tag_; }
+    { tag_ = static_cast< const Downstream* >( &ce )->tag_; }
 }
 #endif
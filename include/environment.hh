@@ -20,7 +20,7 @@ namespace fluke {
     /// quite intricate. The current scope of the environment is that it is
     /// some external mechanism influencing the population. The population has
     /// no influence on the environment though.
-    class Environment : public Subject {
+    class Environment : public ObservedSubject {
         public:
         /// Destructor (empty).
         virtual ~Environment() {};
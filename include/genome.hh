@@ -8,6 +8,8 @@
 #define _FLUKE_GENOME_H_
 
 #include "defs.hh"
+#include "rope.hh"
+#include "arena.hh"
 
 namespace fluke {
 
@@ -20,18 +22,21 @@ namespace fluke {
     /// operators defined on them. On chromosome level the mutational process
     /// is chromosomal tail swapping. Such mutations may occur if double
     /// stranded breaks are not repaired correctly.
-    class Genome {
+    class Genome : public CachedElement {
         public:
+            /// Chromosome container, kept when the genome is pooled
+            typedef std::vector< Chromosome* > chromos_container;
             /// Chromosome iterator 
-            typedef std::list< Chromosome* >::iterator chromos_iter;
+            typedef chromos_container::iterator chromos_iter;
             /// Reverse chromosome iterator
-            typedef std::list< Chromosome* >::reverse_iterator chromos_riter;
+            typedef chromos_container::reverse_iterator chromos_riter;
             /// Constant chromosome iterator
-            typedef std::list< Chromosome* >::const_iterator 
-                const_chromos_iter;
+            typedef chromos_container::const_iterator const_chromos_iter;
             /// Constant reverse chromosome iterator
-            typedef std::list< Chromosome* >::const_reverse_iterator 
+            typedef chromos_container::const_reverse_iterator 
                 const_chromos_riter;
+            /// Chromosomes on the scratch arena, for recombination
+            typedef scratch_vector< Chromosome* >::type chromos_scratch;
 
         public:
             /// (Dummy) constructor
@@ -45,7 +50,13 @@ namespace fluke {
             /// Copy given genome into \c this
             void copy( const Genome & );
             /// Destructor
-            ~Genome();
+            virtual ~Genome();
+            /// Return genome to pool
+            virtual void toPool();
+            /// Take memory from the slabs of the pool
+            static void* operator new( std::size_t );
+            /// Give memory back to the slabs of the pool
+            static void operator delete( void *, std::size_t );
 
             /// Duplicate the genome
             void duplicate();
@@ -53,6 +64,8 @@ namespace fluke {
             Genome* split();
             /// Mutate the genome. Returns number of mutations that occurred
             int mutate(); 
+            /// Duplicate, mutate and split in one go, returns the sister
+            Genome* replicate();
             /// Write the genome to an output stream (in xml format)
             void write( std::ostream & ) const;
 
@@ -60,10 +73,16 @@ namespace fluke {
             std::vector< uint > essentialTags() const;
             /// Return all the tags present of a certain downstream module
             std::vector< uint > moduleTags( int ) const;
+            /// Return the copy numbers of the genes, summed over the 
+            /// chromosomes and sorted on (module, tag), see 
+            /// Chromosome::geneCounts. The result lives on the scratch arena,
+            /// in a \c ScratchScope of the caller.
+            void geneCounts( scratch_vector< std::pair< std::pair< int, uint >,
+                uint > >::type & ) const;
 
             /// Return a pointer to any element but a repeat or retroposon
-            boost::tuple< fluke::Chromosome*, 
-                std::list< ChromosomeElement* >::iterator > randElement();
+            boost::tuple< fluke::Chromosome*, ce_sequence::iterator > 
+                randElement();
             
             /// Get number of chromosomes
             int size() const;
@@ -76,7 +95,10 @@ namespace fluke {
             bool hasMutation() const;
 
             /// Get constant reference to the chromosomes. Used by observers.
-            const std::list< Chromosome* > & chromosomes() const;
+            const chromos_container & chromosomes() const;
+            /// Get number of bytes held by the genome and its chromosomes,
+            /// the element buffers excluded
+            std::size_t bytes() const;
             /// Get nr of transposons
             int nrRetroposons() const;
             /// Get nr of single ltrs
@@ -86,7 +108,7 @@ namespace fluke {
             /// Get nr of dsbs parent had in diploid phase
             boost::tuple< int, int > nrDsbParent() const;
             /// Get nr of dsbs, gene cp/rm
-            std::vector< uint > nrMutations() const;
+            const std::vector< uint > & nrMutations() const;
             /// Reviewer 2: one centromere is healthy
             bool oneCentromere() const;
 
@@ -94,7 +116,7 @@ namespace fluke {
             void clear();
             
         private:
-            std::list< Chromosome* > *chromos_;
+            chromos_container *chromos_;
             // The idea of these two vectors is that they are not changed during
             // the life of an individual, and only get new values at mutating
             // (=reproduction)
@@ -112,13 +134,13 @@ namespace fluke {
     inline bool Genome::empty() const
     { return chromos_->empty(); }
 
-    inline const std::list< fluke::Chromosome* > & Genome::chromosomes() const 
+    inline const Genome::chromos_container & Genome::chromosomes() const 
     { return *chromos_; }
     
     inline boost::tuple< int, int > Genome::nrDsbParent() const
     { return boost::make_tuple( nr_dsbs_parent_[ 0 ], nr_dsbs_parent_[ 1 ] ); }
     
-    inline std::vector< uint > Genome::nrMutations() const
+    inline const std::vector< uint > & Genome::nrMutations() const
     { return nr_mutations_; }
 }
 #endif
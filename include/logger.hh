@@ -10,6 +10,7 @@
 #include "defs.hh"
 #include "observer.hh"
 #include "population.hh"
+#include "chromosome.hh"
 #include "stream_manager.hh"
 
 namespace fluke {
@@ -45,6 +46,30 @@ namespace fluke {
         void writeHeader();
     };
 
+    class LogCsvSharing : public LogObserver {
+        public:
+        LogCsvSharing( std::string, StreamManager *, long );
+        virtual ~LogCsvSharing() {}
+        
+        virtual void doUpdate( Subject * );
+        virtual void finalize() {}
+        
+        private:
+        void writeHeader();
+    };
+
+    class LogCsvMemory : public LogObserver {
+        public:
+        LogCsvMemory( std::string, StreamManager *, long );
+        virtual ~LogCsvMemory() {}
+        
+        virtual void doUpdate( Subject * );
+        virtual void finalize() {}
+        
+        private:
+        void writeHeader();
+    };
+
     class LogCsvRates : public LogObserver {
         public:
         LogCsvRates( std::string, StreamManager *, long );
@@ -24,6 +24,7 @@ namespace fluke {
     /// benefit.
     class ModuleAgent : public Agent {
         friend class AgentReader;
+        friend class ObjectCache< ModuleAgent >;
         public:
         typedef std::vector< Chromosome::tag_container >::iterator module_iter;
         typedef std::vector< Chromosome::tag_container >::const_iterator
@@ -36,19 +37,28 @@ namespace fluke {
         ModuleAgent( const ModuleAgent & );
         /// Destructor
         virtual ~ModuleAgent();
+        /// Take memory from the slabs of the pool, dying agents make room
+        /// for newborns
+        static void* operator new( std::size_t );
+        /// Give memory back to the slabs of the pool
+        static void operator delete( void *, std::size_t );
         /// Cloning the ModuleAgent
         virtual Agent* clone() const;
         /// Copying another ModuleAgent into \c this
         virtual void copy( const Agent & );
+        /// Return to the pool, the gene count vectors keep their memory
+        virtual void toPool();
         
         /// Dummy
         virtual void initialise();
         /// Perform an update step (one simulation timestep)
         virtual void step( Population & );
+        /// Chance to die in a timestep, the death rate
+        virtual double mortality() const;
         /// Reproduction
         virtual Agent* sibling();
         
-        /// Get the score of the agent
+        /// Get the score of the agent (cached, see \c fitness)
         virtual double score() const;
         /// Calculate the score of the individual
         void evaluate( const Environment & );
@@ -61,6 +71,8 @@ namespace fluke {
         
         /// Write a (xml) representation of the agent to stream
         virtual void write( std::ostream & ) const;
+        /// Get number of bytes held by the agent (not by its genome)
+        virtual std::size_t bytes() const;
         
         /// Get the genome
         const Genome& genome() const;
@@ -80,7 +92,7 @@ namespace fluke {
         /// Get nr of dsbs in diploid parent
         boost::tuple< int, int > nrDsbParent() const;
         /// Get a few mutation counters
-        std::vector< uint > nrMutations() const;
+        const std::vector< uint > & nrMutations() const;
         /// Get genotypical distance to target
         int distance() const;
         /// Get distance of parent
@@ -116,14 +128,27 @@ namespace fluke {
         static void retroposonPenaltyRate( double );
         
         protected:
+        /// Constructor of an idle agent for the pool
+        ModuleAgent();
+        /// Start over as constructed with type and genome
+        void reborn( int, Genome* );
         /// Calculate the score of the essential genes
         int essentialsScore( const Environment &env );
         /// Calculate the score of the module genes
         int modulesScore( const Environment &env );
         /// Give it a penalty if too big
         double penalty( double ) const;
+        /// Calculate the score from the genome and the distance
+        double fitness() const;
+        /// Count essential genes in the given copy numbers
+        void countEssentialGenes( const Chromosome::gene_scratch & );
+        /// Count module genes in the given copy numbers
+        void countModuleGenes( const Chromosome::gene_scratch & );
             
         protected:
+        // the flags come first, they fill the tail of Agent
+        /// Flag
+        bool inventorised_;
         /// Current score (a.k.a. fitness)
         int distance_;
         /// Score of parent
@@ -132,8 +157,9 @@ namespace fluke {
         int size_parent_;
         /// Genome of the agent
         Genome *genome_;
-        /// Flag
-        bool inventorised_;
+        /// Cached score, refreshed whenever the genome or the distance
+        /// changes. Hence \c score() only reads, also from other threads.
+        double score_;
         /// Container with nr of module gene tags of \c this genome
         std::vector< Chromosome::tag_container > mod_tags_now_;
         /// Container with nr of essential gene tags of \c this genome
@@ -187,7 +213,7 @@ namespace fluke {
     inline boost::tuple< int, int > ModuleAgent::nrDsbParent() const
     { return genome_->nrDsbParent(); }
     
-    inline std::vector< uint > ModuleAgent::nrMutations() const
+    inline const std::vector< uint > & ModuleAgent::nrMutations() const
     { return genome_->nrMutations(); }
     
     inline int ModuleAgent::distance() const
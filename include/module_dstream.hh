@@ -19,12 +19,13 @@ namespace fluke {
     class ModuleDownstream : public Downstream {
         public:
         /// Constructor.
-        ModuleDownstream() : Downstream(), module_( -1 ) {}
+        ModuleDownstream() : Downstream( MODULE_DSTREAM ), module_( -1 ) {}
         /// Constructor with module tag and identification tag
-        ModuleDownstream( int t, int m ) : Downstream( t ), module_( m ) {}
+        ModuleDownstream( int t, int m ) 
+            : Downstream( MODULE_DSTREAM, t ), module_( m ) {}
         /// Copy constructor.
         explicit ModuleDownstream( const ModuleDownstream &md )
-        { ModuleDownstream::copy( md ); }
+            : Downstream( MODULE_DSTREAM ) { ModuleDownstream::copy( md ); }
         /// Destructor.
         virtual ~ModuleDownstream() {}
         /// Clone \c this.
@@ -33,6 +34,10 @@ namespace fluke {
         virtual void copy( const ChromosomeElement & );
         /// Return to pool.
         virtual void toPool();
+        /// Take memory from the slabs of the pool
+        static void* operator new( std::size_t );
+        /// Give memory back to the slabs of the pool
+        static void operator delete( void *, std::size_t );
         
         /// Mutate the protein(?).
         virtual int mutate();
@@ -37,7 +37,7 @@ namespace fluke {
             /// Subscribe a periodic observer to a subject
             void subscribe( Subject*, LogObserver* );
             /// Subscribe an asynchronous observer to a subject
-            void subscribe( Subject*, AsyncLogObserver* );
+            void subscribe( ObservedSubject*, AsyncLogObserver* );
             /// Remove the subscription of an observer from its subject
             void unsubscribe( Subject*, LogObserver* );
             /// Remove all subscriptions of this subject
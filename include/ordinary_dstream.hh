@@ -19,12 +19,12 @@ namespace fluke {
     class OrdinaryDownstream : public Downstream {
         public:
         /// Constructor.
-        OrdinaryDownstream() : Downstream() {}
+        OrdinaryDownstream() : Downstream( ORDINARY_DSTREAM ) {}
         /// Constructor with tag
-        OrdinaryDownstream( int t ) : Downstream( t ) {}
+        OrdinaryDownstream( int t ) : Downstream( ORDINARY_DSTREAM, t ) {}
         /// Copy constructor.
         OrdinaryDownstream( const OrdinaryDownstream &tp ) 
-        { OrdinaryDownstream::copy( tp ); }
+            : Downstream( ORDINARY_DSTREAM ) { OrdinaryDownstream::copy( tp ); }
         /// Destructor.
         virtual ~OrdinaryDownstream() {}
         /// Clone \c this.
@@ -33,6 +33,10 @@ namespace fluke {
         virtual void copy( const ChromosomeElement & );
         /// Return to pool.
         virtual void toPool();
+        /// Take memory from the slabs of the pool
+        static void* operator new( std::size_t );
+        /// Give memory back to the slabs of the pool
+        static void operator delete( void *, std::size_t );
         
         /// Mutate the protein(?).
         virtual int mutate();
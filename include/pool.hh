@@ -29,6 +29,88 @@ namespace fluke {
     };
 
 
+    /// \class ObjectCacheBase
+    /// \brief Settings and statistics shared by all object caches
+    class ObjectCacheBase {
+        public:
+        /// Virtual dtor.
+        virtual ~ObjectCacheBase() {}
+        
+        /// Set maximum number of idle instances.
+        virtual void highWater( uint ) = 0;
+        /// Get maximum number of idle instances.
+        virtual uint highWater() const = 0;
+        /// Return number of active instances.
+        virtual uint getNrActive() = 0;
+        /// Return number of idle instances.
+        virtual uint getNrIdle() = 0;
+        /// Return number of borrows served by an idle instance.
+        virtual unsigned long getNrHits() = 0;
+        /// Return number of borrows that created an instance.
+        virtual unsigned long getNrMisses() = 0;
+        /// Return number of bytes held in slabs.
+        virtual std::size_t getNrBytes() = 0;
+        /// Return number of bytes in slabs not taken by active instances.
+        virtual std::size_t getNrIdleBytes() = 0;
+        
+        public:
+        /// Set maximum number of idle instances of all caches, present and
+        /// future.
+        static void highWaterMark( uint );
+        /// Get maximum number of idle instances of new caches.
+        static uint highWaterMark();
+        /// Get all caches created so far.
+        static const std::vector< ObjectCacheBase* > & caches();
+        
+        protected:
+        /// Hidden ctor, registers the cache.
+        ObjectCacheBase();
+        
+        private:
+        static std::vector< ObjectCacheBase* > & registry();
+        static boost::mutex & registryMutex();
+        static uint & mark();
+    };
+    
+    inline ObjectCacheBase::ObjectCacheBase() {
+        // caches of different types may be created by different threads
+        boost::mutex::scoped_lock lock( registryMutex() );
+        registry().push_back( this );
+    }
+    
+    inline void ObjectCacheBase::highWaterMark( uint n ) {
+        boost::mutex::scoped_lock lock( registryMutex() );
+        mark() = n;
+        for( std::vector< ObjectCacheBase* >::iterator i = registry().begin();
+            i != registry().end(); ++i ) {
+            ( **i ).highWater( n );
+        }
+    }
+    
+    inline uint ObjectCacheBase::highWaterMark()
+    { return mark(); }
+    
+    inline const std::vector< ObjectCacheBase* > & ObjectCacheBase::caches()
+    { return registry(); }
+    
+    inline std::vector< ObjectCacheBase* > & ObjectCacheBase::registry() {
+        static std::vector< ObjectCacheBase* > result;
+        return result;
+    }
+    
+    // never destroyed, like the caches themselves
+    inline boost::mutex & ObjectCacheBase::registryMutex() {
+        static boost::mutex *result = new boost::mutex();
+        return *result;
+    }
+    
+    // Note: using magic number
+    inline uint & ObjectCacheBase::mark() {
+        static uint result = /*65536*/ 16384;
+        return result;
+    }
+    
+    
     /// \class ObjectCache
     /// \brief The class caches small objects
     ///
@@ -37,10 +119,17 @@ namespace fluke {
     /// is that pooling or caching such small instances speeds up te simulation
     /// considerably.
     ///
+    /// Memory of the instances comes from contiguous blocks (slabs), the
+    /// cached classes route their \c new and \c delete to \c allocate and
+    /// \c deallocate. Free slots are chained through their own storage.
+    /// Idle instances stay constructed, first in a small cache of the 
+    /// calling thread, then in a shared one, up to a high-water mark above
+    /// which they are deleted.
+    ///
     /// Note: uses pointers instead of entire instances.
     /// Question: how to use a factory with this pool?
     template< class T >
-    class ObjectCache {
+    class ObjectCache : public ObjectCacheBase {
         public:
         /// Dtor
         ~ObjectCache();
@@ -54,14 +143,33 @@ namespace fluke {
         
         /// Add an idle instance to the pool.
         void addObject();
-        /// Clear the pool. All instances are destroyed.
+        /// Clear the pool. All idle instances of the shared cache and the
+        /// calling thread are destroyed.
         void clear();
         
-        /// Return number of active instances. These are not under control of
-        /// the pool, so provide an upperbound.
-        uint getNrActive() const;
+        /// Get a slot for an instance (class-specific \c new).
+        void* allocate( std::size_t );
+        /// Give back the slot of an instance (class-specific \c delete).
+        void deallocate( void *, std::size_t );
+        
+        /// Set maximum number of idle instances in the shared cache.
+        virtual void highWater( uint );
+        /// Get maximum number of idle instances in the shared cache.
+        virtual uint highWater() const;
+        
+        /// Return number of active instances (outside the pool). While 
+        /// threads are running, the statistics are estimates.
+        virtual uint getNrActive();
         /// Return number of idle instances.
-        uint getNrIdle() const;
+        virtual uint getNrIdle();
+        /// Return number of borrows served by an idle instance.
+        virtual unsigned long getNrHits();
+        /// Return number of borrows that created an instance.
+        virtual unsigned long getNrMisses();
+        /// Return number of bytes held in slabs.
+        virtual std::size_t getNrBytes();
+        /// Return number of bytes in slabs taken by idle instances or free.
+        virtual std::size_t getNrIdleBytes();
         
         public:
         /// Get the pool.
@@ -74,86 +182,295 @@ namespace fluke {
         ObjectCache( uint );
         
         protected:
-        /// Number of active instances (outside the pool).
-        uint nr_active_;
+        /// Storage of one instance, or the link to the next free one.
+        union slot {
+            slot *next;
+            double align;
+            char storage[ sizeof( T ) ];
+        };
+        /// Idle instances and counts of a single thread.
+        struct local_cache {
+            ObjectCache< T > *owner;
+            std::vector< T* > idle;
+            unsigned long hits, misses;
+        };
+        
+        /// Get the cache of the calling thread.
+        local_cache* local();
+        /// Hand idle instances of a thread back to the shared cache.
+        void flush( local_cache *, uint );
+        /// Thread exit: return the idle instances and keep the counts.
+        static void retire( local_cache * );
+        /// Create the pool, once.
+        static void create();
+        
+        protected:
+        /// Nr of instances per slab.
+        static const uint SLAB = 256;
+        /// Max and refill size of the cache of a thread.
+        static const uint LOCAL_MAX = 64;
+        static const uint LOCAL_BATCH = 32;
+        
+        /// Number of live instances (constructed in a slot).
+        uint nr_live_;
         /// Cap number of idle instances. 
         uint max_idle_;
-        /// The pool itself.
-        std::stack< T* > pool_;
+        /// The shared pool of idle instances.
+        std::vector< T* > pool_;
+        /// Slabs and free slots.
+        std::vector< slot* > slabs_;
+        slot *free_;
+        /// Counts of threads that have finished.
+        unsigned long hits_, misses_;
+        /// Caches of the running threads.
+        std::vector< local_cache* > locals_;
+        boost::thread_specific_ptr< local_cache > local_;
+        /// Guards the pool when the population is stepped in parallel.
+        boost::mutex mutex_;
         
         protected:
         static ObjectCache< T > *instance_;
+        static boost::once_flag once_;
     };
     
     // Note: using magic number
     template< class T >
     ObjectCache< T >::ObjectCache()
-        : nr_active_( 0 ),  max_idle_( 16 ), pool_() {}
+        : nr_live_( 0 ),  max_idle_( 16 ), pool_(), slabs_(), free_( 0 ),
+          hits_( 0 ), misses_( 0 ), locals_(), 
+          local_( &ObjectCache< T >::retire ), mutex_() {}
     
     template< class T >
     ObjectCache< T >::ObjectCache( uint maxIdle ) 
-        : nr_active_( 0 ),  max_idle_( maxIdle ), pool_() {}
+        : nr_live_( 0 ),  max_idle_( maxIdle ), pool_(), slabs_(), free_( 0 ),
+          hits_( 0 ), misses_( 0 ), locals_(), 
+          local_( &ObjectCache< T >::retire ), mutex_() {}
 
     template< class T >
     ObjectCache< T >::~ObjectCache() {
         clear();
+        for( typename std::vector< slot* >::iterator i = slabs_.begin();
+            i != slabs_.end(); ++i ) {
+            delete [] *i;
+        }
     }
         
     template< class T > T*
     ObjectCache< T >::borrowObject() {
-        --nr_active_;
-        if( pool_.empty() ) {
-            addObject();
+        local_cache *aux = local();
+        if( aux->idle.empty() ) {
+            boost::mutex::scoped_lock lock( mutex_ );
+            uint n = std::min< std::size_t >( LOCAL_BATCH, pool_.size() );
+            aux->idle.insert( aux->idle.end(), pool_.end() - n, pool_.end() );
+            pool_.resize( pool_.size() - n );
+        }
+        if( aux->idle.empty() ) {
+            ++aux->misses;
+            return new T();
         }
-        T* result = pool_.top();
-        pool_.pop();
+        ++aux->hits;
+        T* result = aux->idle.back();
+        aux->idle.pop_back();
         return result;
     }
     
     template< class T > void
     ObjectCache< T >::returnObject( T* obj ) {
-        --nr_active_;
-        if( pool_.size() == max_idle_ ) {
+        local_cache *aux = local();
+        aux->idle.push_back( obj );
+        if( aux->idle.size() > LOCAL_MAX ) {
+            flush( aux, LOCAL_BATCH );
+        }
+    }
+    
+    template< class T > void
+    ObjectCache< T >::flush( local_cache *lc, uint keep ) {
+        // move the oldest idle instances, the recent ones are still warm
+        typename std::vector< T* >::iterator last = lc->idle.end() - keep;
+        typename std::vector< T* >::iterator i = lc->idle.begin();
+        {
+            boost::mutex::scoped_lock lock( mutex_ );
+            for( ; i != last && pool_.size() < max_idle_; ++i ) {
+                pool_.push_back( *i );
+            }
+        }
     #ifdef DEBUG
+        if( i != last ) {
             std::cout << "! pool maximally filled" << std::endl;
+        }
     #endif
-            delete obj;
-        } else {
-            pool_.push( obj );
+        // the ones that did not fit are deleted where they are, deleting 
+        // takes the lock again to free the slots
+        for( typename std::vector< T* >::iterator j = i; j != last; ++j ) {
+            delete *j;
         }
+        lc->idle.erase( lc->idle.begin(), last );
     }
     
     template< class T > void
     ObjectCache< T >::addObject() {
         T *obj = new T();
-        pool_.push( obj );
+        boost::mutex::scoped_lock lock( mutex_ );
+        pool_.push_back( obj );
     }
     
     template< class T > void 
     ObjectCache< T >::clear() {
-        while( !pool_.empty() ) {
-            delete pool_.top();
-            pool_.pop();
+        std::vector< T* > aux;
+        {
+            boost::mutex::scoped_lock lock( mutex_ );
+            aux.swap( pool_ );
+        }
+        local_cache *bux = local_.get();
+        if( bux != 0 ) {
+            aux.insert( aux.end(), bux->idle.begin(), bux->idle.end() );
+            bux->idle.clear();
+        }
+        for( typename std::vector< T* >::iterator i = aux.begin(); 
+            i != aux.end(); ++i ) {
+            delete *i;
         }
     }
 
-    template< class T > uint ObjectCache< T >::getNrActive() const
-    { return nr_active_; }
+    template< class T > void*
+    ObjectCache< T >::allocate( std::size_t n ) {
+        // derived classes without a cache of their own
+        if( n != sizeof( T ) ) {
+            return ::operator new( n );
+        }
+        boost::mutex::scoped_lock lock( mutex_ );
+        if( free_ == 0 ) {
+            slot *aux = new slot[ SLAB ];
+            for( uint i = 0; i != SLAB - 1; ++i ) {
+                aux[ i ].next = &aux[ i + 1 ];
+            }
+            aux[ SLAB - 1 ].next = 0;
+            slabs_.push_back( aux );
+            free_ = aux;
+        }
+        slot *result = free_;
+        free_ = free_->next;
+        ++nr_live_;
+        return result;
+    }
+    
+    template< class T > void
+    ObjectCache< T >::deallocate( void *p, std::size_t n ) {
+        if( n != sizeof( T ) ) {
+            ::operator delete( p );
+            return;
+        }
+        boost::mutex::scoped_lock lock( mutex_ );
+        slot *aux = static_cast< slot* >( p );
+        aux->next = free_;
+        free_ = aux;
+        --nr_live_;
+    }
     
-    template< class T > uint ObjectCache< T >::getNrIdle() const
+    template< class T > typename ObjectCache< T >::local_cache*
+    ObjectCache< T >::local() {
+        local_cache *result = local_.get();
+        if( result == 0 ) {
+            result = new local_cache();
+            result->owner = this;
+            result->hits = 0;
+            result->misses = 0;
+            local_.reset( result );
+            boost::mutex::scoped_lock lock( mutex_ );
+            locals_.push_back( result );
+        }
+        return result;
+    }
+    
+    template< class T > void
+    ObjectCache< T >::retire( local_cache *lc ) {
+        ObjectCache< T > *aux = lc->owner;
+        aux->flush( lc, 0 );
+        {
+            boost::mutex::scoped_lock lock( aux->mutex_ );
+            aux->hits_ += lc->hits;
+            aux->misses_ += lc->misses;
+            aux->locals_.erase( std::find( aux->locals_.begin(), 
+                aux->locals_.end(), lc ) );
+        }
+        delete lc;
+    }
+    
+    template< class T > void ObjectCache< T >::highWater( uint n )
+    { max_idle_ = n; }
+    
+    template< class T > uint ObjectCache< T >::highWater() const
     { return max_idle_; }
     
-    // Note: using magic number
+    template< class T > uint 
+    ObjectCache< T >::getNrActive() {
+        uint aux = getNrIdle();
+        boost::mutex::scoped_lock lock( mutex_ );
+        return nr_live_ - aux;
+    }
+    
+    template< class T > uint 
+    ObjectCache< T >::getNrIdle() {
+        boost::mutex::scoped_lock lock( mutex_ );
+        uint result = pool_.size();
+        for( typename std::vector< local_cache* >::iterator i = 
+            locals_.begin(); i != locals_.end(); ++i ) {
+            result += ( **i ).idle.size();
+        }
+        return result;
+    }
+    
+    template< class T > unsigned long 
+    ObjectCache< T >::getNrHits() {
+        boost::mutex::scoped_lock lock( mutex_ );
+        unsigned long result = hits_;
+        for( typename std::vector< local_cache* >::iterator i = 
+            locals_.begin(); i != locals_.end(); ++i ) {
+            result += ( **i ).hits;
+        }
+        return result;
+    }
+    
+    template< class T > unsigned long 
+    ObjectCache< T >::getNrMisses() {
+        boost::mutex::scoped_lock lock( mutex_ );
+        unsigned long result = misses_;
+        for( typename std::vector< local_cache* >::iterator i = 
+            locals_.begin(); i != locals_.end(); ++i ) {
+            result += ( **i ).misses;
+        }
+        return result;
+    }
+    
+    template< class T > std::size_t 
+    ObjectCache< T >::getNrBytes() {
+        boost::mutex::scoped_lock lock( mutex_ );
+        return slabs_.size() * SLAB * sizeof( slot );
+    }
+    
+    template< class T > std::size_t 
+    ObjectCache< T >::getNrIdleBytes() {
+        std::size_t aux = getNrActive() * sizeof( slot );
+        std::size_t bux = getNrBytes();
+        return bux > aux ? bux - aux : 0;
+    }
+    
     template< class T > ObjectCache< T >* 
     ObjectCache< T >::instance() {
-        if( instance_ == 0 ) {
-            instance_ = new ObjectCache< T >( /*65536*/ 16384 );
-        }
+        // tile threads may be the first to use a pool, one of them creates
+        // it and the others wait
+        boost::call_once( &ObjectCache< T >::create, once_ );
         return instance_;
     }
     
+    template< class T > void 
+    ObjectCache< T >::create()
+    { instance_ = new ObjectCache< T >( highWaterMark() ); }
+    
     /// General definition
     template< class T > ObjectCache< T >* ObjectCache< T >::instance_ = 0;
+    template< class T > boost::once_flag ObjectCache< T >::once_ = 
+        BOOST_ONCE_INIT;
     
     /// Extra function related to the use of \c ObjectCache
     ///
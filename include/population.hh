@@ -39,6 +39,133 @@ namespace fluke {
         { return x < l.x || ( x == l.x && y < l.y ); }
     };
 
+    /// \class AgentGrid
+    /// \brief One plane of agents, stored in square blocks.
+    ///
+    /// Replaces a row major \c boost::multi_array. The cells are stored
+    /// block after block, a block being 8 x 8 cells (row major within), so
+    /// a Moore neighbourhood mostly lies within one or two cache friendly
+    /// blocks instead of three rows far apart. The dimensions are padded to
+    /// whole blocks. Access as \c grid[ i ][ j ] and \c shape() still 
+    /// works; \c index() gives the storage position of a cell, such that
+    /// tables running parallel to the grid may follow the same layout.
+    class AgentGrid {
+        public:
+        /// Cells per block edge is 1 << \c BLOCK_SHIFT
+        static const int BLOCK_SHIFT = 3;
+        static const int BLOCK_MASK = ( 1 << BLOCK_SHIFT ) - 1;
+        
+        /// Row of the grid, for \c grid[ i ][ j ]
+        class Row {
+            public:
+            Row( Agent **c, const AgentGrid *g, int i ) 
+                : cells_( c ), grid_( g ), i_( i ) {}
+            Agent*& operator[]( int j ) const
+            { return cells_[ grid_->index( i_, j ) ]; }
+            private:
+            Agent **cells_;
+            const AgentGrid *grid_;
+            int i_;
+        };
+        /// Const row of the grid
+        class ConstRow {
+            public:
+            ConstRow( Agent *const *c, const AgentGrid *g, int i ) 
+                : cells_( c ), grid_( g ), i_( i ) {}
+            Agent* operator[]( int j ) const
+            { return cells_[ grid_->index( i_, j ) ]; }
+            private:
+            Agent *const *cells_;
+            const AgentGrid *grid_;
+            int i_;
+        };
+        
+        public:
+        /// Empty grid
+        AgentGrid();
+        /// Grid of x by y cells, all empty
+        AgentGrid( int, int );
+        
+        /// Get the dimensions (x, y)
+        const uint* shape() const;
+        /// Get a row
+        Row operator[]( int );
+        /// Get a row
+        ConstRow operator[]( int ) const;
+        
+        /// Storage position of a cell
+        int index( int, int ) const;
+        /// Cell at a storage position
+        Agent*& at( int );
+        /// Cell at a storage position
+        Agent* at( int ) const;
+        /// x coordinate of a storage position
+        int row( int ) const;
+        /// y coordinate of a storage position
+        int column( int ) const;
+        /// Number of storage positions (padding included)
+        int capacity() const;
+        /// Number of bytes held by the cells
+        std::size_t bytes() const;
+        
+        private:
+        uint shape_[ 2 ];
+        int blocks_y_;
+        std::vector< Agent* > cells_;
+    };
+
+    /// \class AgentIndex
+    /// \brief Dense index of the agents on one plane of the grid.
+    ///
+    /// Replaces a map from agents to locations. The live agents are kept in
+    /// a contiguous vector and every agent knows its own slot in it, hence
+    /// lookup, insertion and removal are O(1). Removal moves the last entry
+    /// into the hole, so the order of iteration is not preserved. Iterating
+    /// gives pairs of an agent (\c first) and its location (\c second).
+    class AgentIndex {
+        public:
+        /// An agent and its location
+        typedef std::pair< Agent*, Location > entry;
+        /// Entry iterator
+        typedef std::vector< entry >::iterator iterator;
+        /// Const entry iterator
+        typedef std::vector< entry >::const_iterator const_iterator;
+        
+        public:
+        /// Constructor, the plane (0 or 1) selects the slot of the agents
+        explicit AgentIndex( int );
+        
+        /// Get the location of an agent, it is inserted if not present
+        Location& operator[]( Agent * );
+        /// Get the location of an agent (pre: present)
+        const Location& where( const Agent * ) const;
+        /// Is the agent present?
+        bool contains( const Agent * ) const;
+        /// Remove an agent (if present)
+        void erase( Agent * );
+        /// Remove all agents
+        void clear();
+        
+        /// Begin of the agents
+        iterator begin();
+        /// End of the agents
+        iterator end();
+        /// Begin of the agents
+        const_iterator begin() const;
+        /// End of the agents
+        const_iterator end() const;
+        /// Number of agents
+        uint size() const;
+        /// No agents?
+        bool empty() const;
+        /// Number of bytes held by the entries
+        std::size_t bytes() const;
+        
+        private:
+        int plane_;
+        std::vector< entry > entries_;
+    };
+
     /// \class Population
     /// \brief Collection of agents on a grid.
     ///
@@ -48,11 +175,9 @@ namespace fluke {
     class Population : public Subject {
         public:
         /// Typedef of the agent grid
-        typedef boost::multi_array< Agent*, 2 > agents_grid;
+        typedef AgentGrid agents_grid;
         /// Mapping agents on the grid (inverse of a grid)
-        typedef std::map< Agent*, Location > agents_map;
-        /// Range of agent grid
-        typedef agents_grid::index_range range;
+        typedef AgentIndex agents_map;
         /// Agents map iterator
         typedef agents_map::iterator map_ag_iter;
         /// Const agents map iterator
@@ -65,6 +190,8 @@ namespace fluke {
         typedef std::vector< Location >::const_iterator const_loc_iter;
         /// Enumeration for synchronous updating
         enum grid_type { reading, writing };
+        /// Enumeration for the phases of the tiled update
+        enum tile_phase { deciding, birthing };
         
         public:
         /// (Dummy) constructor
@@ -129,6 +256,11 @@ namespace fluke {
         
         /// Get the current number of agents 
         uint nrAgents() const;
+        /// Get number of bytes held by both grid planes and the tables 
+        /// running alongside (neighbour counts, frontier, tiles)
+        std::size_t gridBytes() const;
+        /// Get number of bytes held by the agent indices of both planes
+        std::size_t indexBytes() const;
         /// Is the grid empty?
         bool empty() const;
         /// Special function to see if only one type of agents is left
@@ -163,6 +295,18 @@ namespace fluke {
         static void shuffling( bool );
         /// Are we shuffling?
         static bool shuffling();
+        /// Set the update scheme (synchronous, tiled, event)
+        static void updateScheme( const std::string & );
+        /// Get the update scheme
+        static std::string updateScheme();
+        /// Set the number of worker threads of the tiled update (> 0)
+        static void nrThreads( int );
+        /// Get the number of worker threads
+        static int nrThreads();
+        /// Set the edge length of the tiles of the tiled update (> 0)
+        static void tileSize( int );
+        /// Get the edge length of the tiles
+        static int tileSize();
         
         private:
         class IsNotAvailable :
@@ -173,6 +317,14 @@ namespace fluke {
                 { return ce == static_cast< Agent* >( 0 ); }
         };
         
+        // a birth decided in the tiled update
+        struct Birth {
+            Agent *parent;
+            Agent *child;
+            Location where;
+        };
+        typedef std::vector< Birth >::iterator birth_iter;
+        
         struct SmallerTypeThan :
             public std::binary_function< Agent*, Agent*, bool > {
                 bool operator()( Agent *ag1, Agent *ag2 ) const 
@@ -189,24 +341,87 @@ namespace fluke {
         void locations( std::vector< Location > & );
         // which plane to zero?
         void zero( grid_type );
-        // swap the two planes and make them consistent
+        // swap the two planes and make the dirty cells consistent
         void swap();
-        // swap two locations on a plane
-        void swap( grid_type, const Location &, const Location & );
+        // bring the agent index of a plane up to date with its cells
+        void relocate( grid_type );
         // shuffle the locations of both planes
         void shuffle();
         // do not erase agent, only its pointers in the write plane and map
         void shallowErase( Agent * );
         // do not erase agent, only its pointers...
         void shallowEraseAt( Location );
+        // select a parent for an empty location (or a null pointer)
+        Agent* select( const Location & );
+        // fused neighbourhood, scaling and selection kernel
+        template< class Sc, class Se > Agent* selectWith( const Location & );
+        // bind the kernel matching the scaling and selection schemes
+        void chooseKernel();
+        template< class Sc > void chooseKernel();
+        // precompute the torus wrapping of neighbour indices
+        void wrapTables();
+        // add to the occupied neighbour count of the cells around a location
+        void crowd( const Location &, int );
+        // count the occupied neighbours of all cells of the read plane
+        void recount();
+        // let the parent reproduce, returns the child (not yet inserted)
+        Agent* reproduce( Agent *, const Location & );
+        // sweep over all locations using the global random stream
+        void synchronousStep();
+        // deterministic tile-parallel update
+        void tiledStep();
+        // run a phase of the tiled update on all tiles
+        void runTiles( tile_phase, int );
+        // keep on processing tiles until none are left
+        void tileWorker( tile_phase );
+        // deaths and parent selection within a tile
+        void decideTile( int );
+        // births of the parents living in a tile
+        void birthTile( int );
+        // tile of a location
+        int tileOf( const Location & ) const;
+        // event driven (Gillespie) update of one unit of time
+        void eventStep();
+        // place a newborn on both planes at once (event driven update)
+        void placeNow( Agent *, const Location & );
+        // remove and dispose of an agent from both planes at once
+        void removeNow( Location );
+        // put all empty cells with neighbours in the frontier, and find the
+        // highest mortality
+        void rebuildFrontier();
+        // bring the frontier up to date around a changed location
+        void refreshFrontier( const Location & );
         
         private:
         // read from shadow_grid, write to grid
         agents_grid plane_one_, plane_two_;
         agents_grid *write_grid_, *read_grid_;
-        agents_map write_agents_, read_agents_;
+        agents_map agents_one_, agents_two_;
+        agents_map *write_agents_, *read_agents_;
         
         std::vector< Location > shuffle_locs_;
+        // neighbour index k - 1 on the torus is wrap_x_[ k ] (wrap_y_)
+        std::vector< int > wrap_x_, wrap_y_;
+        Agent* ( Population::*kernel_ )( const Location & );
+        // nr of occupied cells in the Moore neighbourhood of each cell of
+        // the read plane (grid storage order)
+        std::vector< int > nbh_count_;
+        // event driven update: empty cells with neighbours (storage index)
+        // and the position of every cell in it (-1 if absent)
+        std::vector< int > frontier_, frontier_pos_;
+        bool frontier_stale_;
+        // upper bound of the mortality of the agents (event driven update)
+        double max_mortality_;
+        // cells of the write plane changed since the last swap
+        std::vector< Location > dirty_;
+        
+        // tiled update: a random stream, deaths and births per tile
+        std::vector< uniform_gen_type > tile_streams_;
+        std::vector< std::vector< Location > > tile_deaths_;
+        std::vector< std::vector< Birth > > tile_births_, tile_owned_;
+        int nr_tiles_x_, nr_tiles_y_;
+        int next_tile_;
+        boost::mutex tile_mutex_;
         
         ScalingScheme *scaling_;
         SelectionScheme *selection_;
@@ -221,11 +436,117 @@ namespace fluke {
         static double threshold_;
         static int nr_agent_types_;
         static std::string placement_;
+        static std::string update_scheme_;
+        static int threads_;
+        static int tile_size_;
         
         const int agent_view_size_;
     };
 
     
+    inline AgentGrid::AgentGrid() : blocks_y_( 0 ), cells_() 
+    { shape_[ 0 ] = shape_[ 1 ] = 0; }
+
+    inline AgentGrid::AgentGrid( int x, int y ) 
+        : blocks_y_( ( y + BLOCK_MASK ) >> BLOCK_SHIFT ),
+          cells_( ( ( x + BLOCK_MASK ) >> BLOCK_SHIFT ) * blocks_y_ 
+            << ( 2 * BLOCK_SHIFT ), static_cast< Agent* >( 0 ) ) 
+    { shape_[ 0 ] = x; shape_[ 1 ] = y; }
+
+    inline const uint* AgentGrid::shape() const
+    { return shape_; }
+
+    inline AgentGrid::Row AgentGrid::operator[]( int i )
+    { return Row( &cells_[ 0 ], this, i ); }
+
+    inline AgentGrid::ConstRow AgentGrid::operator[]( int i ) const
+    { return ConstRow( &cells_[ 0 ], this, i ); }
+
+    inline int AgentGrid::index( int i, int j ) const {
+        return ( ( ( i >> BLOCK_SHIFT ) * blocks_y_ + ( j >> BLOCK_SHIFT ) ) 
+            << ( 2 * BLOCK_SHIFT ) ) | ( ( i & BLOCK_MASK ) << BLOCK_SHIFT ) 
+            | ( j & BLOCK_MASK );
+    }
+
+    inline Agent*& AgentGrid::at( int k )
+    { return cells_[ k ]; }
+
+    inline Agent* AgentGrid::at( int k ) const
+    { return cells_[ k ]; }
+
+    inline int AgentGrid::row( int k ) const {
+        return ( ( k >> ( 2 * BLOCK_SHIFT ) ) / blocks_y_ << BLOCK_SHIFT ) 
+            | ( ( k >> BLOCK_SHIFT ) & BLOCK_MASK );
+    }
+
+    inline int AgentGrid::column( int k ) const {
+        return ( ( k >> ( 2 * BLOCK_SHIFT ) ) % blocks_y_ << BLOCK_SHIFT ) 
+            | ( k & BLOCK_MASK );
+    }
+
+    inline int AgentGrid::capacity() const
+    { return cells_.size(); }
+
+    inline std::size_t AgentGrid::bytes() const
+    { return heap_bytes( cells_ ); }
+
+    inline AgentIndex::AgentIndex( int p ) : plane_( p ), entries_() {}
+
+    inline Location& AgentIndex::operator[]( Agent *ag ) {
+        int s = ag->slot( plane_ );
+        if( s < 0 ) {
+            s = entries_.size();
+            ag->slot( plane_, s );
+            entries_.push_back( entry( ag, Location() ) );
+        }
+        return entries_[ s ].second;
+    }
+
+    inline const Location& AgentIndex::where( const Agent *ag ) const
+    { return entries_[ ag->slot( plane_ ) ].second; }
+
+    inline bool AgentIndex::contains( const Agent *ag ) const
+    { return ag != 0 && ag->slot( plane_ ) >= 0; }
+
+    inline void AgentIndex::erase( Agent *ag ) {
+        if( contains( ag ) ) {
+            // move the last one into the hole
+            int s = ag->slot( plane_ );
+            entries_[ s ] = entries_.back();
+            entries_[ s ].first->slot( plane_, s );
+            entries_.pop_back();
+            ag->slot( plane_, -1 );
+        }
+    }
+
+    inline void AgentIndex::clear() {
+        for( iterator i = entries_.begin(); i != entries_.end(); ++i ) {
+            i->first->slot( plane_, -1 );
+        }
+        entries_.clear();
+    }
+
+    inline AgentIndex::iterator AgentIndex::begin()
+    { return entries_.begin(); }
+
+    inline AgentIndex::iterator AgentIndex::end()
+    { return entries_.end(); }
+
+    inline AgentIndex::const_iterator AgentIndex::begin() const
+    { return entries_.begin(); }
+
+    inline AgentIndex::const_iterator AgentIndex::end() const
+    { return entries_.end(); }
+
+    inline uint AgentIndex::size() const
+    { return entries_.size(); }
+
+    inline bool AgentIndex::empty() const
+    { return entries_.empty(); }
+
+    inline std::size_t AgentIndex::bytes() const
+    { return heap_bytes( entries_ ); }
+
     /// Overloaded \c << operator for easy writing to streams.
     inline std::ostream& operator<<( std::ostream& os, const Population& pop )
     { pop.write( os ); return os; }
@@ -234,7 +555,7 @@ namespace fluke {
     { return *write_grid_; }
 
     inline const Population::agents_map & Population::map() const
-    { return write_agents_; }
+    { return *write_agents_; }
 
     inline long Population::generation() const
     { return model_->now(); }
@@ -246,10 +567,10 @@ namespace fluke {
     { return model_; }
     
     inline uint Population::nrAgents() const
-    { return write_agents_.size(); }
+    { return write_agents_->size(); }
     
     inline bool Population::empty() const
-    { return write_agents_.empty(); }
+    { return write_agents_->empty(); }
 }
 #endif
 
@@ -32,6 +32,10 @@ namespace fluke {
         virtual void copy( const ChromosomeElement & );
         /// Return Repeat to pool
         virtual void toPool();
+        /// Take memory from the slabs of the pool
+        static void* operator new( std::size_t );
+        /// Give memory back to the slabs of the pool
+        static void operator delete( void *, std::size_t );
         
         /// Dummy mutate or incorporate possibility of DSB?
         virtual int mutate();
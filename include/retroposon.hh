@@ -23,11 +23,11 @@ namespace fluke {
     class Retroposon : public Downstream {
         public:
         /// Constructor.
-        Retroposon() : Downstream() {}
+        Retroposon() : Downstream( RETROPOSON ) {}
         /// Constructor. The \c int is a unique identifier.
-        Retroposon( uint t ) : Downstream( t ) {}
+        Retroposon( uint t ) : Downstream( RETROPOSON, t ) {}
         /// Copy constructor.
-        Retroposon( const Retroposon &rp )
+        Retroposon( const Retroposon &rp ) : Downstream( RETROPOSON )
         { Retroposon::copy( rp ); }
         /// Destructor.
         virtual ~Retroposon() {}
@@ -37,6 +37,10 @@ namespace fluke {
         virtual void copy( const ChromosomeElement & );
         /// Return to pool.
         virtual void toPool();
+        /// Take memory from the slabs of the pool
+        static void* operator new( std::size_t );
+        /// Give memory back to the slabs of the pool
+        static void operator delete( void *, std::size_t );
         
         /// Mutate the protein.
         virtual int mutate();
@@ -0,0 +1,713 @@
+//
+// Chunked sequence (rope) for very long chromosomes.
+//
+// by Anton Crombach, A.B.M.Crombach@bio.uu.nl
+//
+
+#ifndef _FLUKE_ROPE_H_
+#define _FLUKE_ROPE_H_
+
+#include "defs.hh"
+
+namespace fluke {
+
+    /// \class Rope
+    /// \brief Sequence kept as a row of bounded chunks.
+    ///
+    /// Insertions and erasures only move the elements of one chunk (at most
+    /// \c CHUNK of them) and the running offsets of the chunks behind it,
+    /// random access is a binary search over these offsets. Splitting off a
+    /// tail and concatenating move whole chunks.
+    ///
+    /// The interface mimics the part of \c std::vector used by Chromosome,
+    /// so either can be its buffer. Iterators are random access and, as
+    /// with a vector, invalidated by insertions and erasures.
+    template< class T >
+    class Rope {
+        public:
+        typedef T value_type;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::vector< T > chunk;
+        /// Maximum nr of elements in a chunk
+        static const size_type CHUNK = 512;
+
+        /// Iterator over a rope, \c R is the (const) rope and \c V the
+        /// (const) value type
+        template< class R, class V >
+        class basic_iterator {
+            template< class S, class W > friend class basic_iterator;
+            friend class Rope;
+            public:
+            typedef std::random_access_iterator_tag iterator_category;
+            typedef T value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef V* pointer;
+            typedef V& reference;
+
+            basic_iterator() : rope_( 0 ), c_( 0 ), p_( 0 ) {}
+            basic_iterator( R *r, size_type c, size_type p )
+                : rope_( r ), c_( c ), p_( p ) {}
+            /// From iterator to const_iterator
+            template< class S, class W >
+            basic_iterator( const basic_iterator< S, W > &i )
+                : rope_( i.rope_ ), c_( i.c_ ), p_( i.p_ ) {}
+
+            V& operator*() const
+            { return ( *rope_->chunks_[ c_ ] )[ p_ ]; }
+            V* operator->() const
+            { return &**this; }
+            V& operator[]( difference_type n ) const
+            { return *( *this + n ); }
+
+            basic_iterator& operator++() {
+                if( ++p_ == rope_->chunks_[ c_ ]->size() ) {
+                    ++c_;
+                    p_ = 0;
+                }
+                return *this;
+            }
+            basic_iterator operator++( int )
+            { basic_iterator aux( *this ); ++*this; return aux; }
+            basic_iterator& operator--() {
+                if( p_ == 0 ) {
+                    --c_;
+                    p_ = rope_->chunks_[ c_ ]->size() - 1;
+                } else {
+                    --p_;
+                }
+                return *this;
+            }
+            basic_iterator operator--( int )
+            { basic_iterator aux( *this ); --*this; return aux; }
+            basic_iterator& operator+=( difference_type n ) {
+                // stay within the chunk if we can
+                difference_type q = n + static_cast< difference_type >( p_ );
+                if( q >= 0 && c_ < rope_->chunks_.size() &&
+                    q < static_cast< difference_type >(
+                        rope_->chunks_[ c_ ]->size() ) ) {
+                    p_ = q;
+                } else {
+                    rope_->locate( index() + n, c_, p_ );
+                }
+                return *this;
+            }
+            basic_iterator& operator-=( difference_type n )
+            { return *this += -n; }
+            basic_iterator operator+( difference_type n ) const
+            { basic_iterator aux( *this ); return aux += n; }
+            basic_iterator operator-( difference_type n ) const
+            { basic_iterator aux( *this ); return aux += -n; }
+            template< class S, class W >
+            difference_type operator-( const basic_iterator< S, W > &i ) const
+            { return static_cast< difference_type >( index() ) - i.index(); }
+
+            template< class S, class W >
+            bool operator==( const basic_iterator< S, W > &i ) const
+            { return c_ == i.c_ && p_ == i.p_; }
+            template< class S, class W >
+            bool operator!=( const basic_iterator< S, W > &i ) const
+            { return !( *this == i ); }
+            template< class S, class W >
+            bool operator<( const basic_iterator< S, W > &i ) const
+            { return c_ < i.c_ || ( c_ == i.c_ && p_ < i.p_ ); }
+            template< class S, class W >
+            bool operator>( const basic_iterator< S, W > &i ) const
+            { return i < *this; }
+            template< class S, class W >
+            bool operator<=( const basic_iterator< S, W > &i ) const
+            { return !( i < *this ); }
+            template< class S, class W >
+            bool operator>=( const basic_iterator< S, W > &i ) const
+            { return !( *this < i ); }
+
+            /// Position in the rope
+            size_type index() const
+            { return rope_->offsets_[ c_ ] + p_; }
+
+            private:
+            R *rope_;
+            size_type c_;
+            size_type p_;
+        };
+
+        typedef basic_iterator< Rope, T > iterator;
+        typedef basic_iterator< const Rope, const T > const_iterator;
+        typedef std::reverse_iterator< iterator > reverse_iterator;
+        typedef std::reverse_iterator< const_iterator > const_reverse_iterator;
+
+        public:
+        /// Constructor
+        Rope() : chunks_(), offsets_( 1, 0 ) {}
+        /// Constructor, filling the rope with a range
+        template< class In >
+        Rope( In first, In last ) : chunks_(), offsets_( 1, 0 )
+        { insert( end(), first, last ); }
+        /// Copy constructor
+        Rope( const Rope &r ) : chunks_(), offsets_( 1, 0 )
+        { insert( end(), r.begin(), r.end() ); }
+        /// Destructor
+        ~Rope()
+        { clear(); }
+        /// Assignment
+        Rope& operator=( const Rope &r )
+        { Rope aux( r ); swap( aux ); return *this; }
+
+        iterator begin()
+        { return iterator( this, 0, 0 ); }
+        iterator end()
+        { return iterator( this, chunks_.size(), 0 ); }
+        const_iterator begin() const
+        { return const_iterator( this, 0, 0 ); }
+        const_iterator end() const
+        { return const_iterator( this, chunks_.size(), 0 ); }
+        reverse_iterator rbegin()
+        { return reverse_iterator( end() ); }
+        reverse_iterator rend()
+        { return reverse_iterator( begin() ); }
+        const_reverse_iterator rbegin() const
+        { return const_reverse_iterator( end() ); }
+        const_reverse_iterator rend() const
+        { return const_reverse_iterator( begin() ); }
+
+        size_type size() const
+        { return offsets_.back(); }
+        bool empty() const
+        { return chunks_.empty(); }
+        T& operator[]( size_type k )
+        { size_type c, p; locate( k, c, p ); return ( *chunks_[ c ] )[ p ]; }
+        const T& operator[]( size_type k ) const
+        { size_type c, p; locate( k, c, p ); return ( *chunks_[ c ] )[ p ]; }
+        /// There is nothing to reserve in a rope
+        void reserve( size_type ) {}
+
+        /// Empty the rope
+        void clear() {
+            for( size_type c = 0; c != chunks_.size(); ++c ) {
+                delete chunks_[ c ];
+            }
+            chunks_.clear();
+            offsets_.assign( 1, 0 );
+        }
+        /// Swap contents
+        void swap( Rope &r ) {
+            chunks_.swap( r.chunks_ );
+            offsets_.swap( r.offsets_ );
+        }
+        void push_back( const T &t )
+        { insert( end(), t ); }
+
+        /// Insert one element in front of \c i
+        iterator insert( iterator i, const T &t ) {
+            size_type k = i.index();
+            insert( i, &t, &t + 1 );
+            return begin() += k;
+        }
+        /// Insert a range in front of \c i
+        template< class In >
+        void insert( iterator i, In first, In last ) {
+            if( first == last ) return;
+            if( chunks_.empty() ) {
+                chunks_.push_back( new chunk() );
+                offsets_.push_back( 0 );
+                i = begin();
+            }
+            size_type c = i.c_;
+            size_type p = i.p_;
+            if( c == chunks_.size() ) {
+                // at the end, append to the last chunk
+                --c;
+                p = chunks_[ c ]->size();
+            }
+            chunks_[ c ]->insert( chunks_[ c ]->begin() + p, first, last );
+            split( c );
+        }
+        /// Erase one element
+        iterator erase( iterator i )
+        { iterator j( i ); return erase( i, ++j ); }
+        /// Erase a range
+        iterator erase( iterator first, iterator last ) {
+            if( first == last ) return first;
+            size_type k = first.index();
+            size_type c = first.c_;
+            size_type d = last.c_;
+            if( c == d ) {
+                chunks_[ c ]->erase( chunks_[ c ]->begin() + first.p_,
+                    chunks_[ c ]->begin() + last.p_ );
+            } else {
+                chunks_[ c ]->erase( chunks_[ c ]->begin() + first.p_,
+                    chunks_[ c ]->end() );
+                for( size_type e = c + 1; e != d; ++e ) {
+                    delete chunks_[ e ];
+                }
+                if( d != chunks_.size() ) {
+                    chunks_[ d ]->erase( chunks_[ d ]->begin(),
+                        chunks_[ d ]->begin() + last.p_ );
+                }
+                chunks_.erase( chunks_.begin() + c + 1, chunks_.begin() + d );
+            }
+            merge( c );
+            return begin() += k;
+        }
+
+        /// Move the elements from \c i onwards to the end of \c r
+        void splitOff( iterator i, Rope &r ) {
+            if( i == end() ) return;
+            size_type c = i.c_;
+            size_type n = r.chunks_.size();
+            if( i.p_ != 0 ) {
+                // cut the chunk itself
+                chunk *aux = chunks_[ c ];
+                r.chunks_.push_back( new chunk( aux->begin() + i.p_,
+                    aux->end() ) );
+                aux->erase( aux->begin() + i.p_, aux->end() );
+                ++c;
+            }
+            r.chunks_.insert( r.chunks_.end(), chunks_.begin() + c,
+                chunks_.end() );
+            chunks_.erase( chunks_.begin() + c, chunks_.end() );
+            merge( chunks_.size() );
+            r.merge( n );
+        }
+        /// Move all elements of \c r to the end of \c this
+        void append( Rope &r ) {
+            size_type n = chunks_.size();
+            chunks_.insert( chunks_.end(), r.chunks_.begin(), r.chunks_.end() );
+            r.chunks_.clear();
+            r.offsets_.assign( 1, 0 );
+            merge( n );
+        }
+
+        private:
+        template< class R, class V > friend class basic_iterator;
+        // find chunk and position of the k-th element
+        void locate( size_type k, size_type &c, size_type &p ) const {
+            c = std::upper_bound( offsets_.begin(), offsets_.end(), k )
+                - offsets_.begin() - 1;
+            if( c == chunks_.size() ) {
+                p = 0;
+            } else {
+                p = k - offsets_[ c ];
+            }
+        }
+        // running offsets from chunk c onwards
+        void update( size_type c ) {
+            offsets_.resize( chunks_.size() + 1 );
+            for( ; c < chunks_.size(); ++c ) {
+                offsets_[ c + 1 ] = offsets_[ c ] + chunks_[ c ]->size();
+            }
+        }
+        // split an overfull chunk c in equal parts
+        void split( size_type c ) {
+            size_type n = chunks_[ c ]->size();
+            if( n > CHUNK ) {
+                chunk *aux = chunks_[ c ];
+                size_type k = ( n + CHUNK - 1 ) / CHUNK;
+                std::vector< chunk* > bux;
+                for( size_type e = 1; e != k; ++e ) {
+                    bux.push_back( new chunk( aux->begin() + e * n / k,
+                        aux->begin() + ( e + 1 ) * n / k ) );
+                }
+                aux->erase( aux->begin() + n / k, aux->end() );
+                chunks_.insert( chunks_.begin() + c + 1, bux.begin(),
+                    bux.end() );
+            }
+            update( c );
+        }
+        // drop empty chunks and join small neighbours around chunk c
+        void merge( size_type c ) {
+            if( c > 0 ) --c;
+            size_type e = c;
+            size_type last = std::min( c + 3, chunks_.size() );
+            while( e < last ) {
+                if( chunks_[ e ]->empty() ) {
+                    delete chunks_[ e ];
+                    chunks_.erase( chunks_.begin() + e );
+                    --last;
+                } else if( e + 1 < last && chunks_[ e ]->size() +
+                    chunks_[ e + 1 ]->size() <= CHUNK / 2 ) {
+                    chunks_[ e ]->insert( chunks_[ e ]->end(),
+                        chunks_[ e + 1 ]->begin(), chunks_[ e + 1 ]->end() );
+                    delete chunks_[ e + 1 ];
+                    chunks_.erase( chunks_.begin() + e + 1 );
+                    --last;
+                } else {
+                    ++e;
+                }
+            }
+            update( c );
+        }
+
+        private:
+        std::vector< chunk* > chunks_;
+        // offsets_[ c ] is the position of the first element of chunk c,
+        // the last entry is the size of the rope
+        std::vector< size_type > offsets_;
+    };
+
+    template< class T >
+    const typename Rope< T >::size_type Rope< T >::CHUNK;
+
+    /// Move the elements from \c i onwards to the end of another vector
+    template< class T > void
+    split_off( std::vector< T > &s, typename std::vector< T >::iterator i,
+        std::vector< T > &t ) {
+        t.insert( t.end(), i, s.end() );
+        s.erase( i, s.end() );
+    }
+
+    /// Move the elements from \c i onwards to the end of another rope
+    template< class T > void
+    split_off( Rope< T > &s, typename Rope< T >::iterator i, Rope< T > &t )
+    { s.splitOff( i, t ); }
+
+    /// Move all elements of the second vector to the end of the first
+    template< class T > void
+    concatenate( std::vector< T > &s, std::vector< T > &t ) {
+        s.insert( s.end(), t.begin(), t.end() );
+        t.clear();
+    }
+
+    /// Move all elements of the second rope to the end of the first
+    template< class T > void
+    concatenate( Rope< T > &s, Rope< T > &t )
+    { s.append( t ); }
+
+
+    /// \class PositionSet
+    /// \brief Ascending positions into a rope, such as those of the broken
+    /// repeats on a chromosome.
+    ///
+    /// An insertion or erasure in the rope shifts all positions behind it.
+    /// In a plain vector that touches each of them, here the positions are
+    /// kept in chunks (at most \c CHUNK each) that share a base, so a shift
+    /// only touches one chunk and the bases behind it.
+    class PositionSet {
+        public:
+        typedef std::size_t size_type;
+        /// Maximum nr of positions in a chunk
+        static const size_type CHUNK = 512;
+
+        public:
+        /// Constructor
+        PositionSet() : chunks_(), bases_(), counts_( 1, 0 ) {}
+        /// Copy constructor
+        PositionSet( const PositionSet &s ) 
+            : chunks_(), bases_( s.bases_ ), counts_( s.counts_ ) {
+            for( size_type c = 0; c != s.chunks_.size(); ++c ) {
+                chunks_.push_back( new chunk( *s.chunks_[ c ] ) );
+            }
+        }
+        /// Destructor
+        ~PositionSet()
+        { clear(); }
+        /// Assignment
+        PositionSet& operator=( const PositionSet &s )
+        { PositionSet aux( s ); swap( aux ); return *this; }
+
+        size_type size() const
+        { return counts_.back(); }
+        bool empty() const
+        { return chunks_.empty(); }
+        /// Get the k-th position
+        uint operator[]( size_type k ) const {
+            size_type c = std::upper_bound( counts_.begin(), counts_.end(), 
+                k ) - counts_.begin() - 1;
+            return bases_[ c ] + ( *chunks_[ c ] )[ k - counts_[ c ] ];
+        }
+        bool operator==( const PositionSet &s ) const {
+            if( size() != s.size() ) return false;
+            for( size_type k = 0; k != size(); ++k ) {
+                if( ( *this )[ k ] != s[ k ] ) return false;
+            }
+            return true;
+        }
+        /// Get number of bytes held by the chunks
+        std::size_t bytes() const {
+            std::size_t result = ( chunks_.capacity() + bases_.capacity() ) *
+                sizeof( void* ) + counts_.capacity() * sizeof( size_type );
+            for( size_type c = 0; c != chunks_.size(); ++c ) {
+                result += sizeof( chunk ) + 
+                    chunks_[ c ]->capacity() * sizeof( uint );
+            }
+            return result;
+        }
+
+        /// Empty the set
+        void clear() {
+            for( size_type c = 0; c != chunks_.size(); ++c ) {
+                delete chunks_[ c ];
+            }
+            chunks_.clear();
+            bases_.clear();
+            counts_.assign( 1, 0 );
+        }
+        /// Swap contents
+        void swap( PositionSet &s ) {
+            chunks_.swap( s.chunks_ );
+            bases_.swap( s.bases_ );
+            counts_.swap( s.counts_ );
+        }
+        /// Add a position behind all others
+        void push_back( uint k ) {
+            if( chunks_.empty() || chunks_.back()->size() == CHUNK ) {
+                chunks_.push_back( new chunk() );
+                bases_.push_back( k );
+                counts_.push_back( counts_.back() );
+            }
+            chunks_.back()->push_back( k - bases_.back() );
+            ++counts_.back();
+        }
+        /// Add a position
+        void insert( uint k ) {
+            if( chunks_.empty() ) {
+                push_back( k );
+                return;
+            }
+            size_type c = std::min( find( k ), chunks_.size() - 1 );
+            if( static_cast< int >( k ) < bases_[ c ] ) {
+                rebase( c, 0 );
+            }
+            chunk *aux = chunks_[ c ];
+            aux->insert( aux->begin() + lower( c, k ), k - bases_[ c ] );
+            if( aux->size() > CHUNK ) {
+                // split in halves
+                chunks_.insert( chunks_.begin() + c + 1, 
+                    new chunk( aux->begin() + aux->size() / 2, aux->end() ) );
+                bases_.insert( bases_.begin() + c + 1, bases_[ c ] );
+                aux->erase( aux->begin() + aux->size() / 2, aux->end() );
+            }
+            update( c );
+        }
+        /// Remove the positions in [first, last)
+        void erase( uint first, uint last ) {
+            size_type c = find( first );
+            size_type e = c;
+            while( e < chunks_.size() && 
+                bases_[ e ] + static_cast< int >( chunks_[ e ]->front() ) < 
+                static_cast< int >( last ) ) {
+                chunk *aux = chunks_[ e ];
+                aux->erase( aux->begin() + lower( e, first ), 
+                    aux->begin() + lower( e, last ) );
+                if( aux->empty() ) {
+                    remove( e );
+                } else {
+                    ++e;
+                }
+            }
+            merge( c );
+        }
+        /// Add n to the positions from k onwards. When n is negative, there
+        /// should be no positions in [k + n, k).
+        void shift( uint k, int n ) {
+            size_type c = find( k );
+            if( c == chunks_.size() ) return;
+            size_type p = lower( c, k );
+            if( p == 0 ) {
+                bases_[ c ] += n;
+            } else {
+                for( chunk::iterator i = chunks_[ c ]->begin() + p; 
+                    i != chunks_[ c ]->end(); ++i ) {
+                    *i += n;
+                }
+            }
+            for( ++c; c != chunks_.size(); ++c ) {
+                bases_[ c ] += n;
+            }
+        }
+        /// Move the positions from k onwards to \c s, less k. The former
+        /// contents of \c s are dropped.
+        void splitOff( uint k, PositionSet &s ) {
+            s.clear();
+            size_type c = find( k );
+            if( c == chunks_.size() ) return;
+            size_type p = lower( c, k );
+            if( p != 0 ) {
+                // cut the chunk itself
+                chunk *aux = chunks_[ c ];
+                s.chunks_.push_back( new chunk( aux->begin() + p, 
+                    aux->end() ) );
+                s.bases_.push_back( bases_[ c ] - static_cast< int >( k ) );
+                aux->erase( aux->begin() + p, aux->end() );
+                ++c;
+            }
+            for( size_type e = c; e != chunks_.size(); ++e ) {
+                s.chunks_.push_back( chunks_[ e ] );
+                s.bases_.push_back( bases_[ e ] - static_cast< int >( k ) );
+            }
+            chunks_.erase( chunks_.begin() + c, chunks_.end() );
+            bases_.erase( bases_.begin() + c, bases_.end() );
+            merge( chunks_.size() );
+            s.merge( 0 );
+        }
+        /// Move all positions of \c s, plus k, behind those of \c this
+        void append( PositionSet &s, uint k ) {
+            size_type c = chunks_.size();
+            chunks_.insert( chunks_.end(), s.chunks_.begin(), 
+                s.chunks_.end() );
+            for( size_type e = 0; e != s.bases_.size(); ++e ) {
+                bases_.push_back( s.bases_[ e ] + static_cast< int >( k ) );
+            }
+            s.chunks_.clear();
+            s.bases_.clear();
+            s.counts_.assign( 1, 0 );
+            merge( c );
+        }
+
+        private:
+        typedef std::vector< uint > chunk;
+        // first chunk with a position of k or more, or the nr of chunks
+        size_type find( uint k ) const {
+            size_type lo = 0, hi = chunks_.size();
+            while( lo != hi ) {
+                size_type mid = ( lo + hi ) / 2;
+                if( bases_[ mid ] + static_cast< int >( chunks_[ mid ]->back() )
+                    < static_cast< int >( k ) ) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            return lo;
+        }
+        // index of the first position of k or more in chunk c
+        size_type lower( size_type c, uint k ) const {
+            if( static_cast< int >( k ) <= bases_[ c ] ) return 0;
+            return std::lower_bound( chunks_[ c ]->begin(), 
+                chunks_[ c ]->end(), k - bases_[ c ] ) - chunks_[ c ]->begin();
+        }
+        // give chunk c another base
+        void rebase( size_type c, int b ) {
+            for( chunk::iterator i = chunks_[ c ]->begin(); 
+                i != chunks_[ c ]->end(); ++i ) {
+                *i += bases_[ c ] - b;
+            }
+            bases_[ c ] = b;
+        }
+        void remove( size_type c ) {
+            delete chunks_[ c ];
+            chunks_.erase( chunks_.begin() + c );
+            bases_.erase( bases_.begin() + c );
+        }
+        // running counts from chunk c onwards
+        void update( size_type c ) {
+            counts_.resize( chunks_.size() + 1 );
+            for( ; c < chunks_.size(); ++c ) {
+                counts_[ c + 1 ] = counts_[ c ] + chunks_[ c ]->size();
+            }
+        }
+        // join small neighbours around chunk c
+        void merge( size_type c ) {
+            if( c > 0 ) --c;
+            size_type e = c;
+            size_type last = std::min( c + 3, chunks_.size() );
+            while( e + 1 < last ) {
+                if( chunks_[ e ]->size() + chunks_[ e + 1 ]->size() <= 
+                    CHUNK / 2 ) {
+                    // the positions of e + 1 lie above the base of e
+                    rebase( e + 1, bases_[ e ] );
+                    chunks_[ e ]->insert( chunks_[ e ]->end(),
+                        chunks_[ e + 1 ]->begin(), chunks_[ e + 1 ]->end() );
+                    remove( e + 1 );
+                    --last;
+                } else {
+                    ++e;
+                }
+            }
+            update( c );
+        }
+
+        private:
+        // position = base + entry, the entries of a chunk ascend
+        std::vector< chunk* > chunks_;
+        std::vector< int > bases_;
+        // counts_[ c ] is the nr of positions in front of chunk c, the last
+        // entry is the size of the set
+        std::vector< size_type > counts_;
+    };
+
+    /// Bytes held by the chunks of a position set
+    inline std::size_t heap_bytes( const PositionSet &s )
+    { return s.bytes(); }
+
+    /// Add a position to an ascending vector
+    inline void 
+    insert_position( std::vector< uint > &s, uint k )
+    { s.insert( std::lower_bound( s.begin(), s.end(), k ), k ); }
+
+    /// Add a position to a set
+    inline void 
+    insert_position( PositionSet &s, uint k )
+    { s.insert( k ); }
+
+    /// Remove the positions in [first, last) from an ascending vector
+    inline void 
+    erase_positions( std::vector< uint > &s, uint first, uint last ) {
+        std::vector< uint >::iterator i = std::lower_bound( s.begin(), 
+            s.end(), first );
+        s.erase( i, std::lower_bound( i, s.end(), last ) );
+    }
+
+    /// Remove the positions in [first, last) from a set
+    inline void 
+    erase_positions( PositionSet &s, uint first, uint last )
+    { s.erase( first, last ); }
+
+    /// Add n to the positions from k onwards in an ascending vector
+    inline void 
+    shift_positions( std::vector< uint > &s, uint k, int n ) {
+        for( std::vector< uint >::iterator i = std::lower_bound( s.begin(), 
+            s.end(), k ); i != s.end(); ++i ) {
+            *i += n;
+        }
+    }
+
+    /// Add n to the positions from k onwards in a set
+    inline void 
+    shift_positions( PositionSet &s, uint k, int n )
+    { s.shift( k, n ); }
+
+    /// Move the positions from k onwards, less k, to another vector
+    inline void 
+    split_positions( std::vector< uint > &s, uint k, std::vector< uint > &t ) {
+        std::vector< uint >::iterator i = std::lower_bound( s.begin(), 
+            s.end(), k );
+        t.clear();
+        for( std::vector< uint >::iterator j = i; j != s.end(); ++j ) {
+            t.push_back( *j - k );
+        }
+        s.erase( i, s.end() );
+    }
+
+    /// Move the positions from k onwards, less k, to another set
+    inline void 
+    split_positions( PositionSet &s, uint k, PositionSet &t )
+    { s.splitOff( k, t ); }
+
+    /// Move all positions of the second vector, plus k, to the first
+    inline void 
+    append_positions( std::vector< uint > &s, std::vector< uint > &t, uint k ) {
+        for( std::vector< uint >::iterator i = t.begin(); i != t.end(); ++i ) {
+            s.push_back( *i + k );
+        }
+        t.clear();
+    }
+
+    /// Move all positions of the second set, plus k, to the first
+    inline void 
+    append_positions( PositionSet &s, PositionSet &t, uint k )
+    { s.append( t, k ); }
+
+    /// Buffer of chromosome elements (see Chromosome) and ascending 
+    /// positions into it. Genomes of 10^5 elements and up are better off 
+    /// with a rope, compile with ROPE_CHROMOSOME defined.
+#ifdef ROPE_CHROMOSOME
+    typedef Rope< ChromosomeElement* > ce_sequence;
+    typedef PositionSet ce_positions;
+#else
+    typedef std::vector< ChromosomeElement* > ce_sequence;
+    typedef std::vector< uint > ce_positions;
+#endif
+}
+#endif
+
@@ -23,8 +23,13 @@ namespace fluke {
             /// Cloning is very handy
             virtual ScalingScheme* clone() const = 0;
     
-            /// Signature of the scaling method
-            virtual void scale( std::vector< double > & ) = 0;
+            /// Signature of the scaling method, scales an array of scores
+            /// in place.
+            virtual void scale( double *, int ) = 0;
+            /// Statically bound scaling. Derived schemes hide it by an
+            /// inline version, such that the selection kernel of the
+            /// population avoids the virtual call.
+            void apply( double *, int );
 
         protected:
             /// Constructor
@@ -45,11 +50,18 @@ namespace fluke {
             virtual ScalingScheme* clone() const;
 
             /// Scale the scores, but not really ;)
-            virtual void scale( std::vector< double > & );
+            virtual void scale( double *, int );
+            /// Inline version of \c scale
+            void apply( double *, int ) const;
     };
 
+    inline void ScalingScheme::apply( double *scores, int n )
+    { scale( scores, n ); }
+
     inline ScalingScheme* NoScaling::clone() const
     { return new NoScaling(); }
+
+    inline void NoScaling::apply( double *, int ) const {}
     
     /// \class LinearScaling
     /// \brief Linearly scale the scores from \f$[0, \infty)\f$ to \f$[0,1]\f$
@@ -69,7 +81,9 @@ namespace fluke {
             virtual ScalingScheme* clone() const;
             
             /// Scale the scores linearly
-            virtual void scale( std::vector< double > & );
+            virtual void scale( double *, int );
+            /// Inline version of \c scale
+            void apply( double *, int ) const;
         private:
             double base_score_;
     };
@@ -77,6 +91,26 @@ namespace fluke {
     inline ScalingScheme* LinearScaling::clone() const
     { return new LinearScaling( base_score_ ); }
 
+    inline void LinearScaling::apply( double *scores, int n ) const {
+        // pre: scores are in range [0..++)
+        //
+        // note: as in the previous Python implementation, I patched the 
+        // algorithm with the feature that if the max is zero, all the scores
+        // are set to a base fitness (otherwise all the scores would be zero
+        // and the selection would always pick the not-do-anything option).
+        double mx = *( std::max_element( scores, scores + n ) );
+        // if the max is almost zero, they're all zero. So fill with base score
+        if( close_to( mx, static_cast< double >( 0.0 ) ) ) {
+            std::fill( scores, scores + n, base_score_ );
+        } else {
+            // note: if all scores are the same, the scaling will result in 
+            // all scores being one
+            for( int i = 0; i < n; ++i ) {
+                scores[ i ] /= mx;
+            }
+        }
+    }
+
     /// \class PowerScaling
     /// \brief All scores are raised to a specified power (default 2).
     class PowerScaling : public ScalingScheme {
@@ -92,8 +126,10 @@ namespace fluke {
 
             virtual ScalingScheme* clone() const;
             
-            /// Scale the scores linearly
-            virtual void scale( std::vector< double > & );
+            /// Scale the scores by a power
+            virtual void scale( double *, int );
+            /// Inline version of \c scale
+            void apply( double *, int ) const;
         private:
             double base_score_;
             double power_;
@@ -101,6 +137,22 @@ namespace fluke {
 
     inline ScalingScheme* PowerScaling::clone() const
     { return new PowerScaling( base_score_, power_ ); }
+
+    inline void PowerScaling::apply( double *scores, int n ) const {
+        // pre: scores are in range [0..1)
+        //
+        // note: as with linear scaling, if the max is zero all the scores
+        // are set to a base fitness.
+        double mx = *( std::max_element( scores, scores + n ) );
+        // if the max is almost zero, they're all zero. So fill with base score
+        if( close_to( mx, static_cast< double >( 0.0 ) ) ) {
+            std::fill( scores, scores + n, base_score_ );
+        } else {
+            for( int i = 0; i < n; ++i ) {
+                scores[ i ] = pow( scores[ i ], power_ );
+            }
+        }
+    }
 }
 #endif
 
@@ -14,8 +14,8 @@ namespace fluke {
     /// \class SelectionScheme
     /// \brief An agent is selected for reproduction on basis of its score
     ///
-    /// Given a list of agents and a list of scores (and assuming both are 
-    /// ordered equivallently), one agent is selected.
+    /// Given an array of agents and an array of their cumulative scores (and
+    /// assuming both are ordered equivallently), one agent is selected.
     class SelectionScheme {
         public:
             /// Destructor
@@ -23,9 +23,13 @@ namespace fluke {
             /// Cloning is very handy
             virtual SelectionScheme* clone() const = 0;
             
-            /// Signature of the select method
-            virtual Agent* select( 
-                    std::vector< Agent* > &, std::vector< double > & ) = 0;
+            /// Signature of the select method, given agents, cumulative 
+            /// scores and their number
+            virtual Agent* select( Agent **, const double *, int ) = 0;
+            /// Statically bound selection. Derived schemes hide it by an
+            /// inline version, such that the selection kernel of the 
+            /// population avoids the virtual call.
+            Agent* pick( Agent **, const double *, int );
 
         protected:
             /// Constructor
@@ -47,12 +51,22 @@ namespace fluke {
             virtual SelectionScheme* clone() const;
 
             /// Select an agent (randomly)
-            virtual Agent* select( 
-                    std::vector< Agent* > &, std::vector< double > & );
+            virtual Agent* select( Agent **, const double *, int );
+            /// Inline version of \c select
+            Agent* pick( Agent **, const double *, int ) const;
     };
 
+    inline Agent* SelectionScheme::pick( Agent **va, const double *sc, int n )
+    { return select( va, sc, n ); }
+
     inline SelectionScheme* RandSelection::clone() const
     { return new RandSelection(); }
+
+    inline Agent* 
+    RandSelection::pick( Agent **va, const double *, int n ) const {
+        // note: ignoring scores
+        return va[ rand_range( static_cast< uint >( n ) ) ];
+    }
     
     /// \class ProbalisticSelection
     /// \brief Pick an agent linearly based on its score
@@ -70,12 +84,20 @@ namespace fluke {
             virtual SelectionScheme* clone() const;
 
             /// Select an agent on its score
-            virtual Agent* select( 
-                    std::vector< Agent* > &, std::vector< double > & );
+            virtual Agent* select( Agent **, const double *, int );
+            /// Inline version of \c select
+            Agent* pick( Agent **, const double *, int ) const;
     };
             
     inline SelectionScheme* ProbalisticSelection::clone() const
     { return new ProbalisticSelection(); }
+
+    inline Agent* 
+    ProbalisticSelection::pick( Agent **va, const double *sc, int n ) const {
+        // note: the "no-selection" case may be a 0-pointer in 'va'
+        return va[ std::upper_bound( sc, sc + n, 
+            rand_range( sc[ n - 1 ] ) ) - sc ];
+    }
 }
 #endif
 
@@ -53,6 +53,8 @@ namespace fluke {
 
             /// Return the short sequence, given a reference
             std::string strShortSeq( label ) const;
+            /// Get number of bytes held by the sequence and reference tables
+            std::size_t bytes() const;
 
         public:
             /// Set the maximum hamming distance, such that two short sequences
@@ -71,6 +73,8 @@ namespace fluke {
             double mutation_rate_;
             std::vector< std::string > *short_seqs_;
             std::vector< int > *references_;
+            // reference counts are shared by parallel tiles
+            boost::mutex ref_mutex_;
 
             randrange_gen_type rand_length_;
             randrange_gen_type rand_repository_;
@@ -37,6 +37,8 @@ namespace fluke {
             /// Perform one timestep. It consists of checking whether the
             /// agent dies or survives another timestep.
             virtual void step( Population & );
+            /// Chance to die in a timestep, the death rate
+            virtual double mortality() const;
             /// Reproduce. The sibling has its age reset to zero.
             virtual Agent* sibling();
 
@@ -46,6 +48,8 @@ namespace fluke {
             virtual void evaluate( const Environment & );
             /// Another empty function
             virtual int distance() const;            
+            /// Get number of bytes held by the agent.
+            virtual std::size_t bytes() const;
             /// Write a text representation of the agent to an output stream.
             virtual void write( std::ostream & ) const;
             
@@ -73,6 +77,9 @@ namespace fluke {
     inline double SimpleAgent::score() const
     { return score_; }
 
+    inline std::size_t SimpleAgent::bytes() const
+    { return sizeof( SimpleAgent ); }
+
     inline void SimpleAgent::evaluate( const Environment &env )
     { throw "Not implemented for SimpleAgent"; }
     
@@ -17,18 +17,33 @@ namespace fluke {
     /// The observer/subject pattern is used to decouple the actual model from
     /// data gathering (separation of concerns). In \c fluke the subjects are 
     /// parts of the model, f.i. the population, a specific agent, genes.
+    ///
+    /// A subject carries no state, observers that are kept by the subject
+    /// itself need an \c ObservedSubject. Hence, the many agents handed 
+    /// to observers stay small.
     class Subject {
+        public:
+            /// Constructor
+            Subject() {};
+            /// Destructor
+            virtual ~Subject() {};
+    };
+
+    /// \class ObservedSubject
+    /// \brief Subject keeping a list of observers to notify.
+    class ObservedSubject : public Subject {
         public:
             /// Observer list iterator
             typedef std::list< Observer* >::iterator obs_iter;
 
         public:
             /// Constructor
-            Subject() : obs_() {};
+            ObservedSubject() : Subject(), obs_() {};
             /// Copy constructor
-            Subject( const Subject &s ) : obs_( s.obs_ ) {};
+            ObservedSubject( const ObservedSubject &s ) 
+                : Subject(), obs_( s.obs_ ) {};
             /// Destructor
-            virtual ~Subject() {};
+            virtual ~ObservedSubject() {};
 
             /// Register an observer with \c this
             void attach( Observer* );
@@ -20,9 +20,11 @@ namespace fluke {
     class TranscriptionFactor : public Downstream {
         public:
         /// Constructor.
-        TranscriptionFactor() : Downstream(), tf_( -1 ) {}
+        TranscriptionFactor() 
+            : Downstream( TRANSCRIPTION_FACTOR ), tf_( -1 ) {}
         /// Constructor with tag and label to give.
-        TranscriptionFactor( uint t, label l ) : Downstream( t ), tf_( l ) {}
+        TranscriptionFactor( uint t, label l ) 
+            : Downstream( TRANSCRIPTION_FACTOR, t ), tf_( l ) {}
         /// Copy constructor.
         explicit TranscriptionFactor( const TranscriptionFactor & );
         /// Destructor.
@@ -33,6 +35,10 @@ namespace fluke {
         virtual void copy( const ChromosomeElement & );
         /// Return to pool.
         virtual void toPool();
+        /// Take memory from the slabs of the pool
+        static void* operator new( std::size_t );
+        /// Give memory back to the slabs of the pool
+        static void operator delete( void *, std::size_t );
         
         /// Mutate the protein; its recognition site.
         virtual int mutate();
@@ -53,6 +59,8 @@ namespace fluke {
         public:
         /// Set terminal repeat manager.
         static void shortSeqManager( ShortSeqManager * );
+        /// Get short sequence manager
+        static ShortSeqManager* shortSeqManager();
 
         private:
         label tf_;
@@ -77,6 +77,12 @@ namespace fluke {
         return bux / aux;
     }
 
+    /// Bytes held by the buffer of a vector
+    template< class T, class A > std::size_t
+    heap_bytes( const std::vector< T, A > &v ) {
+        return v.capacity() * sizeof( T );
+    }
+
     /// Retrieve random element
     template< class For, class RandomGenerator > For
     random_element( For first, For last, RandomGenerator &rangen ) {
@@ -6,16 +6,31 @@
 
 #include "agent.hh"
 
+// no per-agent observers, packed tags
+BOOST_STATIC_ASSERT( sizeof( fluke::Agent ) <= 
+    sizeof( void* ) + 2 * sizeof( boost::uint64_t ) + 4 * sizeof( int ) );
+
 fluke::Agent::Agent() 
-: dying_( false ), me_(), ancestor_(), type_( -1 ) {}
+: me_( AgentTag().pack() ), ancestor_( AgentTag().pack() ), type_( -1 ), 
+  dying_( false ) {
+    slot_[ 0 ] = slot_[ 1 ] = -1;
+}
 
 fluke::Agent::Agent( AgentTag t ) 
-: dying_( false ), me_( t ), ancestor_(), type_( -1 ) {}
+: me_( t.pack() ), ancestor_( AgentTag().pack() ), type_( -1 ), 
+  dying_( false ) {
+    slot_[ 0 ] = slot_[ 1 ] = -1;
+}
 
 fluke::Agent::Agent( int tt ) 
-: dying_( false ), me_(), ancestor_(), type_( tt ) {}
+: me_( AgentTag().pack() ), ancestor_( AgentTag().pack() ), type_( tt ), 
+  dying_( false ) {
+    slot_[ 0 ] = slot_[ 1 ] = -1;
+}
 
 fluke::Agent::Agent( const Agent &ag ) {
+    // a copy is not (yet) on the grid
+    slot_[ 0 ] = slot_[ 1 ] = -1;
     copy( ag );
 }
 
@@ -27,3 +42,6 @@ fluke::Agent::copy( const Agent &ag ) {
     type_ = ag.type_;
 }
 
+void
+fluke::Agent::toPool()
+{ delete this; }
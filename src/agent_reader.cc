@@ -153,6 +153,8 @@ fluke::AgentReader::endElement( const XMLCh* const uri,
         chromo_->removeRepeatRate( 
             factory_->conf_->optionAsDouble( "rm_ltr", type_ ) );
         chromo_->mutationScheme( factory_->mutateRates( type_ ) );
+        chromo_->skipAhead( factory_->conf_->optionAsString( 
+            "mutate_sampling", type_ ) == "skip" );
     }
 }
 
@@ -0,0 +1,93 @@
+//
+// Stand-alone timing of the inner loops of the mutation model.
+//
+// by Anton Crombach, A.B.M.Crombach@bio.uu.nl
+//
+
+#include "defs.hh"
+#include "config.hh"
+#include "factory.hh"
+#include "genome.hh"
+#include "chromosome.hh"
+
+#include <boost/timer.hpp>
+
+using namespace std;
+using namespace fluke;
+
+// globals...
+base_generator_type fluke::generator( 18 );
+UniformStream fluke::uniform( fluke::generator );
+
+// Usage: bench_chromosome -c <config>
+//
+// A genome of agent type 1 is built as the simulation would, seeded with
+// init_seed. Every round, a fresh copy of it is mutated chromosome by
+// chromosome (its first write includes the copy of the shared buffer, as
+// in reproduction), after which the gene tags of the genome are collected.
+// The number of rounds is end_time.
+int
+main( int argc, char **argv ) {
+    int result = 1;
+    try {
+        Config conf;
+        conf.parseCmdLine( argc, argv );
+        conf.parseFile();
+        conf.parseAgentFile( "agent1.cfg" );
+        generator.seed( conf.optionAsInt( "init_seed" ) );
+        uniform_gen_type aux( generator );
+        uniform = aux;
+
+        Factory factory( &conf );
+        Genome *genome = factory.genome( 1 );
+        long rounds = conf.optionAsLong( "end_time" );
+        cout << "Genome of " << genome->fullSize() << " elements in "
+             << genome->chromosomes().size() << " chromosome(s), "
+             << rounds << " rounds, seed " << conf.optionAsInt( "init_seed" )
+             << endl;
+
+        // mutate copies, the elements they gain or lose are counted such
+        // that the work cannot be optimised away
+        double mutate_time = 0.0;
+        long nr_elements = 0;
+        for( long r = 0; r != rounds; ++r ) {
+            Genome *bux = genome->clone();
+            {
+                ScratchScope scope;
+                boost::timer tt;
+                for( Genome::const_chromos_iter i = bux->chromosomes().begin();
+                    i != bux->chromosomes().end(); ++i ) {
+                    ( **i ).mutate();
+                }
+                mutate_time += tt.elapsed();
+            }
+            nr_elements += bux->fullSize() - genome->fullSize();
+            bux->toPool();
+        }
+
+        // collect the tags of the essential genes
+        double tags_time = 0.0;
+        long nr_tags = 0;
+        {
+            boost::timer tt;
+            for( long r = 0; r != rounds; ++r ) {
+                nr_tags += genome->essentialTags().size();
+            }
+            tags_time = tt.elapsed();
+        }
+
+        cout << "Chromosome::mutate: " << mutate_time << " s, "
+             << 1e6 * mutate_time / rounds << " us per genome ("
+             << nr_elements << " elements gained)" << endl;
+        cout << "Genome::essentialTags: " << tags_time << " s, "
+             << 1e6 * tags_time / rounds << " us per genome ("
+             << nr_tags << " tags)" << endl;
+        genome->toPool();
+        result = 0;
+    } catch( const char *e ) {
+        cout << "Exception: " << e << endl;
+    } catch( exception &e ) {
+        cout << "Exception: " << e.what() << endl;
+    }
+    return result;
+}
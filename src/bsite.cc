@@ -12,9 +12,11 @@ template<> fluke::ObjectCache< fluke::BindingSite >*
 fluke::ObjectCache< fluke::BindingSite >::instance_ = 0;
 
 
-fluke::BindingSite::BindingSite() : ChromosomeElement(), tfbs_( -1 ) {}
+fluke::BindingSite::BindingSite() 
+    : ChromosomeElement( BINDING_SITE ), tfbs_( -1 ) {}
 
-fluke::BindingSite::BindingSite( label l ) : ChromosomeElement(), tfbs_( l ) {}
+fluke::BindingSite::BindingSite( label l ) 
+    : ChromosomeElement( BINDING_SITE ), tfbs_( l ) {}
 
 fluke::BindingSite::BindingSite( const BindingSite &bs ) 
     : ChromosomeElement( bs ) {
@@ -47,6 +49,14 @@ fluke::BindingSite::toPool() {
     ObjectCache< BindingSite >::instance()->returnObject( this );
 }
 
+void*
+fluke::BindingSite::operator new( std::size_t n ) 
+{ return ObjectCache< BindingSite >::instance()->allocate( n ); }
+
+void
+fluke::BindingSite::operator delete( void *p, std::size_t n ) 
+{ ObjectCache< BindingSite >::instance()->deallocate( p, n ); }
+
 int 
 fluke::BindingSite::mutate() {
     int result = 0;
@@ -10,7 +10,7 @@
 template<> fluke::ObjectCache< fluke::Centromere >* 
 fluke::ObjectCache< fluke::Centromere >::instance_ = 0;
 
-fluke::Centromere::Centromere() : ChromosomeElement() {}
+fluke::Centromere::Centromere() : ChromosomeElement( CENTROMERE ) {}
 
 fluke::Centromere::Centromere( const Centromere &tp ) 
     : ChromosomeElement( tp ) {
@@ -32,6 +32,14 @@ fluke::Centromere::toPool() {
     ObjectCache< Centromere >::instance()->returnObject( this );
 }
 
+void*
+fluke::Centromere::operator new( std::size_t n ) 
+{ return ObjectCache< Centromere >::instance()->allocate( n ); }
+
+void
+fluke::Centromere::operator delete( void *p, std::size_t n ) 
+{ ObjectCache< Centromere >::instance()->deallocate( p, n ); }
+
 std::string 
 fluke::Centromere::asXmlString() const { 
     return std::string( "<centromere/>\n" );
@@ -10,38 +10,79 @@
 
 template<> fluke::ObjectCache< fluke::Chromosome >* 
 fluke::ObjectCache< fluke::Chromosome >::instance_ = 0;
+template<> fluke::ObjectCache< fluke::Chromosome::ce_container >* 
+fluke::ObjectCache< fluke::Chromosome::ce_container >::instance_ = 0;
 fluke::MutateRates *fluke::Chromosome::rate_mutator_ = 0;
+bool fluke::Chromosome::interning_ = false;
+fluke::Chromosome::intern_table fluke::Chromosome::interned_buffers_;
+std::size_t fluke::Chromosome::intern_sweep_ = 1024;
+boost::mutex fluke::Chromosome::intern_mutex_;
+
+// the element flags share a word with the fields of the concrete classes
+BOOST_STATIC_ASSERT( sizeof( fluke::BindingSite ) <= 
+    sizeof( void* ) + 2 * sizeof( int ) );
+BOOST_STATIC_ASSERT( sizeof( fluke::Repeat ) <= 
+    sizeof( void* ) + 2 * sizeof( int ) );
+BOOST_STATIC_ASSERT( sizeof( fluke::Retroposon ) <= 
+    sizeof( void* ) + 2 * sizeof( int ) );
+BOOST_STATIC_ASSERT( sizeof( fluke::OrdinaryDownstream ) <= 
+    sizeof( void* ) + 2 * sizeof( int ) );
+BOOST_STATIC_ASSERT( sizeof( fluke::Centromere ) <= 
+    sizeof( void* ) + 2 * sizeof( int ) );
+BOOST_STATIC_ASSERT( sizeof( fluke::TranscriptionFactor ) <= 
+    2 * sizeof( void* ) + 2 * sizeof( int ) );
+BOOST_STATIC_ASSERT( sizeof( fluke::ModuleDownstream ) <= 
+    2 * sizeof( void* ) + 2 * sizeof( int ) );
 
 // note: using magic number
 fluke::Chromosome::Chromosome() 
-    : parent_( 0 ), chro_( new std::list< ChromosomeElement* >() ),
+    : parent_( 0 ), chro_( newBuffer() ),
       mut_events_( 6, 0 ), nr_retroposons_( 0 ), nr_ltr_( 0 ), len_( 0 ),
-      update_retro_( true ), update_ltr_( true ), update_len_( true ) {}
+      update_retro_( true ), update_ltr_( true ), update_len_( true ),
+      dsbs_(), targets_(), update_targets_( true ), interned_( false ),
+      skip_ahead_( false ), inactive_( false ), hash_( 0 ) {}
 
 // note: using magic number
 fluke::Chromosome::Chromosome( Genome *g, std::list< ChromosomeElement* > *ll ) 
-    : parent_( g ), chro_( ll ), mut_events_( 6, 0 ), nr_retroposons_( 0 ),
-      nr_ltr_( 0 ), len_( ll->size() ), update_retro_( true ),
-      update_ltr_( true ), update_len_( true ) {}
+    : parent_( g ), 
+      chro_( new ce_container( ll->begin(), ll->end() ), ReturnElements() ),
+      mut_events_( 6, 0 ), 
+      nr_retroposons_( 0 ), nr_ltr_( 0 ), len_( chro_->size() ), 
+      update_retro_( true ), update_ltr_( true ), update_len_( true ),
+      dsbs_(), targets_(), update_targets_( true ), interned_( false ),
+      skip_ahead_( false ), inactive_( false ), hash_( 0 ) {
+    delete ll;
+    recountGenes();
+    for( uint k = 0; k != chro_->size(); ++k ) {
+        if( IsDoubleStrandBreak()( ( *chro_ )[ k ] ) ) dsbs_.push_back( k );
+    }
+}
 
 fluke::Chromosome::Chromosome( const Chromosome &c ) 
-    : chro_( new std::list< ChromosomeElement* >() ), mut_events_( 6, 0 ) {
+    : chro_( newBuffer() ), mut_events_( 6, 0 ),
+      dsbs_(), targets_(), update_targets_( true ), interned_( false ),
+      skip_ahead_( false ), inactive_( false ), hash_( 0 ) {
     copy( c );
 }
 
 fluke::Chromosome::~Chromosome() {
-    smart_erase( *chro_, chro_->begin(), chro_->end() );
-    delete chro_;
+    // the last one sharing the elements returns them
 }
 
 void
 fluke::Chromosome::copy( const Chromosome &c ) {
+    // pre: \c this is empty
     parent_ = c.parent_;
-    for( ce_iter i = c.chro_->begin(); i != c.chro_->end(); ++i ) {
-        ChromosomeElement *aux = ( **i ).clone();
-        chro_->push_back( aux );
-    }
+    chro_ = c.chro_;
     std::copy( c.mut_events_.begin(), c.mut_events_.end(), mut_events_.begin());
+    genes_ = c.genes_;
+    dsbs_ = c.dsbs_;
+    // a copy rarely receives insertions, index it when needed (it then 
+    // clones all its elements in own() anyway)
+    update_targets_ = true;
+    interned_ = c.interned_;
+    inactive_ = c.inactive_;
+    hash_ = c.hash_;
     nr_retroposons_ = c.nr_retroposons_;
     nr_ltr_ = c.nr_ltr_;
     len_ = c.len_;
@@ -60,9 +101,18 @@ fluke::Chromosome::clone() const {
 
 void
 fluke::Chromosome::toPool() {
-    // empty everything
-    smart_return( *chro_, chro_->begin(), chro_->end() );
+    // empty everything, keeping the buffer if it is ours alone
+    if( chro_.unique() ) {
+        smart_return( *chro_, chro_->begin(), chro_->end() );
+    } else {
+        chro_ = newBuffer();
+    }
     std::fill_n( mut_events_.begin(), 6, 0 );
+    genes_.clear();
+    dsbs_.clear();
+    update_targets_ = true;
+    interned_ = false;
+    inactive_ = false;
     nr_retroposons_ = 0;
     nr_ltr_ = 0;
     len_ = 0;    
@@ -72,6 +122,59 @@ fluke::Chromosome::toPool() {
     ObjectCache< Chromosome >::instance()->returnObject( this );
 }
 
+void*
+fluke::Chromosome::operator new( std::size_t n ) 
+{ return ObjectCache< Chromosome >::instance()->allocate( n ); }
+
+void
+fluke::Chromosome::operator delete( void *p, std::size_t n ) 
+{ ObjectCache< Chromosome >::instance()->deallocate( p, n ); }
+
+void
+fluke::Chromosome::ReturnElements::operator()( ce_container *c ) const {
+    smart_return( *c, c->begin(), c->end() );
+    ObjectCache< ce_container >::instance()->returnObject( c );
+}
+
+fluke::Chromosome::shared_container
+fluke::Chromosome::newBuffer() {
+    // the buffer keeps its capacity in the pool, and the counts of the 
+    // shared pointers come from a pool as well
+    return shared_container( 
+        ObjectCache< ce_container >::instance()->borrowObject(), 
+        ReturnElements(), boost::fast_pool_allocator< shared_container >() );
+}
+
+void
+fluke::Chromosome::own() {
+    // the use count only drops behind our back, so a unique buffer stays so
+    // (see Population::tiledStep)
+    if( !chro_.unique() ) {
+        shared_container aux( newBuffer() );
+        aux->reserve( chro_->size() );
+        for( const_ce_iter i = chro_->begin(); i != chro_->end(); ++i ) {
+            // pooled clones do not carry the activity flag, we are likely
+            // in the middle of a mutation pass
+            ChromosomeElement *bux = ( **i ).clone();
+            if( ( **i ).isActive() ) {
+                bux->activate();
+            } else {
+                bux->inactivate();
+            }
+            aux->push_back( bux );
+        }
+        chro_ = aux;
+        interned_ = false;
+    }
+}
+
+fluke::Chromosome::ce_iter
+fluke::Chromosome::own( ce_iter i ) {
+    int k = std::distance( chro_->begin(), i );
+    own();
+    return chro_->begin() + k;
+}
+
 int
 fluke::Chromosome::mutate() {
     // make sure everything is in correct state
@@ -79,31 +182,48 @@ fluke::Chromosome::mutate() {
     // first insert new retroposons
     newRetrotransposon();
     // now loop
+    if( skip_ahead_ ) {
+        skipAheadMutate();
+    } else {
+        elementMutate();
+    }
+    // and now mutate rates
+    if( !close_to( mut_rate_, 0.0 ) ) rate_mutator_->mutate( *this );
+    return 0;
+}
+
+void
+fluke::Chromosome::elementMutate() {
     ce_iter i = chro_->begin();
     while( i != chro_->end() ) {
         // note: it is a bit tricky, but incrementing i is done in the methods
         if( ( **i ).isActive() ) {
-            /* if( IsBindingSite()( *i ) ) {
-                result += ( **i ).mutate();
-                i = bsiteMutate( i );
-            } else */ if( IsTrueDstream()( *i ) ) {
-                // note: downstreams do not have mutations internally
-                /* result += ( **i ).mutate(); */
-                i = geneMutate( i );
-            } else if( IsRepeat()( *i ) ) {
-                i = repeatMutate( i );
-            } else if( IsRetroposon()( *i ) ) {
-                i = retroposonMutate( i );
-            } else if( IsCentromere()( *i ) ) {
-                ++i;
+            switch( ( **i ).kind() ) {
+                /* case ChromosomeElement::BINDING_SITE:
+                    result += ( **i ).mutate();
+                    i = bsiteMutate( i );
+                    break; */
+                case ChromosomeElement::TRANSCRIPTION_FACTOR:
+                case ChromosomeElement::ORDINARY_DSTREAM:
+                case ChromosomeElement::MODULE_DSTREAM:
+                    // note: downstreams do not have mutations internally
+                    /* result += ( **i ).mutate(); */
+                    i = geneMutate( i );
+                    break;
+                case ChromosomeElement::REPEAT:
+                    i = repeatMutate( i );
+                    break;
+                case ChromosomeElement::RETROPOSON:
+                    i = retroposonMutate( i );
+                    break;
+                default:
+                    ++i;
+                    break;
             }
         } else {
             ++i;
         }
     }
-    // and now mutate rates
-    if( !close_to( mut_rate_, 0.0 ) ) rate_mutator_->mutate( *this );
-    return 0;
 }
 
 void
@@ -120,28 +240,123 @@ fluke::Chromosome::newRetrotransposon() {
         ce_iter cux;
         boost::tie( bux, cux ) = randGenomeElement();
         // insert
-        bux->chro_->insert( cux, new Repeat() );
-        bux->chro_->insert( cux, new Retroposon( rand_range( 100 ) + 100 ) );
-        bux->chro_->insert( cux, new Repeat() );
+        ChromosomeElement *dux[ 3 ];
+        dux[ 0 ] = new Repeat();
+        dux[ 1 ] = new Retroposon( rand_range( 100 ) + 100 );
+        dux[ 2 ] = new Repeat();
+        uint k = std::distance( bux->chro_->begin(), cux );
+        bux->chro_->insert( cux, dux, dux + 3 );
+        bux->elementsInserted( k, 3 );
         ++nr_retroposons_;
         nr_ltr_ += 2;
         len_ += 3;
     }
 }
 
+void
+fluke::Chromosome::skipAheadMutate() {
+    // Every active element of a class has the same chance of an event, so
+    // the number of elements passing without one is geometric. Draw that
+    // gap, walk past the elements and draw again after each event. The
+    // kind of event is drawn conditional on having one.
+    //
+    // Repeats without an event are not visited, so repair the breaks left
+    // over now, like elementMutate does on its way.
+    if( !dsbs_.empty() ) {
+        own();
+        for( uint k = 0; k != dsbs_.size(); ++k ) {
+            static_cast< Repeat* >( ( *chro_ )[ dsbs_[ k ] ] )->repairDSB();
+        }
+        dsbs_.clear();
+    }
+    double pg = std::min( cp_gene_rate_ + rm_gene_rate_, 1.0 );
+    double pl = std::min( dsb_recombination_ + rm_ltr_rate_, 1.0 );
+    double pr = std::min( cp_tp_rate_ + rm_tp_rate_, 1.0 );
+    int gg = skipLength( pg );
+    int gl = skipLength( pl );
+    int gr = skipLength( pr );
+    ce_iter i = chro_->begin();
+    while( i != chro_->end() ) {
+        if( ( **i ).isActive() ) {
+            switch( ( **i ).kind() ) {
+                case ChromosomeElement::TRANSCRIPTION_FACTOR:
+                case ChromosomeElement::ORDINARY_DSTREAM:
+                case ChromosomeElement::MODULE_DSTREAM:
+                    if( gg > 0 ) {
+                        --gg;
+                        ++i;
+                    } else {
+                        i = geneMutate( i, pg * uniform() );
+                        gg = skipLength( pg );
+                    }
+                    break;
+                case ChromosomeElement::REPEAT:
+                    if( gl > 0 ) {
+                        --gl;
+                        ++i;
+                    } else {
+                        i = repeatMutate( i, pl * uniform() );
+                        gl = skipLength( pl );
+                    }
+                    break;
+                case ChromosomeElement::RETROPOSON:
+                    if( gr > 0 ) {
+                        --gr;
+                        ++i;
+                    } else {
+                        i = retroposonMutate( i, pr * uniform() );
+                        gr = skipLength( pr );
+                    }
+                    break;
+                default:
+                    ++i;
+                    break;
+            }
+        } else {
+            ++i;
+        }
+    }
+}
+
+int
+fluke::Chromosome::skipLength( double p ) const {
+    // nr of failures before the first success, with success probability p
+    if( close_to( p, 0.0 ) ) {
+        return std::numeric_limits< int >::max();
+    } else if( p >= 1.0 ) {
+        return 0;
+    }
+    double aux = floor( log( 1.0 - uniform() ) / log( 1.0 - p ) );
+    return static_cast< int >( std::min( aux, 
+        static_cast< double >( std::numeric_limits< int >::max() ) ) );
+}
+
 fluke::Chromosome::ce_iter
 fluke::Chromosome::repeatMutate( ce_iter i ) {
     if( close_to( dsb_recombination_ + rm_ltr_rate_, 0.0 ) ) {
         return boost::next( i );
     }
-    Repeat *aux = dynamic_cast< Repeat* >( *i );
+    return repeatMutate( i, uniform() );
+}
+
+fluke::Chromosome::ce_iter
+fluke::Chromosome::repeatMutate( ce_iter i, double uu ) {
+    if( static_cast< Repeat* >( *i )->hasDSB() ||
+        uu < dsb_recombination_ + rm_ltr_rate_ ) {
+        i = own( i );
+    }
+    Repeat *aux = static_cast< Repeat* >( *i );
     // just in case (patch)
-    aux->repairDSB();
-    double uu = uniform();
+    if( aux->hasDSB() ) {
+        aux->repairDSB();
+        forgetBreak( std::distance( chro_->begin(), i ) );
+    }
     if( uu < dsb_recombination_ ) {
         // needs to be repaired @ genome level
         aux->induceDSB();
+        recordBreak( std::distance( chro_->begin(), i ) );
         ( **i ).inactivate();
+        inactive_ = true;
         ++i;
         ++mut_events_[ DSB ];
         //std::cout << "dsb" << std::endl;
@@ -152,6 +367,7 @@ fluke::Chromosome::repeatMutate( ce_iter i ) {
                 ++i;
             } else {
                 i = smart_return( *chro_, i );
+                elementsErased( std::distance( chro_->begin(), i ), 1 );
                 ++mut_events_[ RM_LTR ];
                 //std::cout << "ltr" << std::endl;
                 --nr_ltr_;
@@ -162,6 +378,7 @@ fluke::Chromosome::repeatMutate( ce_iter i ) {
                 ++i;
             } else {
                 i = smart_return( *chro_, i );
+                elementsErased( std::distance( chro_->begin(), i ), 1 );
                 ++mut_events_[ RM_LTR ];
                 //std::cout << "ltr" << std::endl;
                 --nr_ltr_;
@@ -173,6 +390,7 @@ fluke::Chromosome::repeatMutate( ce_iter i ) {
                 ++i;
             } else {
                 i = smart_return( *chro_, i );
+                elementsErased( std::distance( chro_->begin(), i ), 1 );
                 ++mut_events_[ RM_LTR ];
                 //std::cout << "ltr" << std::endl;
                 --nr_ltr_;
@@ -226,7 +444,14 @@ fluke::Chromosome::geneMutate( ce_iter i ) {
     if( close_to( cp_gene_rate_ + rm_gene_rate_, 0.0 ) ) {
         return boost::next( i );
     }
-    double uu = uniform();
+    return geneMutate( i, uniform() );
+}
+
+fluke::Chromosome::ce_iter
+fluke::Chromosome::geneMutate( ce_iter i, double uu ) {
+    if( uu < cp_gene_rate_ + rm_gene_rate_ ) {
+        i = own( i );
+    }
     if( uu < cp_gene_rate_ ) {
         // insert a copy of the current gene somewhere in the genome
         Chromosome *aux;
@@ -235,7 +460,8 @@ fluke::Chromosome::geneMutate( ce_iter i ) {
         // find the gene
         ce_iter ll = upstreamSelect( i );
         ce_iter rr = boost::next( i );
-        std::list< ChromosomeElement* > cux;
+        ce_scratch cux;
+        cux.reserve( std::distance( ll, rr ) );
         uint tt = 0;
         for( ce_iter j = ll; j != rr; ++j ) {
             ChromosomeElement *dux = ( **j ).clone();
@@ -243,7 +469,13 @@ fluke::Chromosome::geneMutate( ce_iter i ) {
             cux.push_back( dux );
             ++tt;
         }
+        // inserting into this chromosome moves the elements behind bux
+        int k = std::distance( chro_->begin(), i );
+        if( aux == this && bux <= i ) {
+            k += tt;
+        }
         aux->splice( bux, cux, tt, 0 );
+        i = chro_->begin() + k;
         ++mut_events_[ CP_G ];
         //std::cout << "cpg" << std::endl;
         ++i;
@@ -251,8 +483,11 @@ fluke::Chromosome::geneMutate( ce_iter i ) {
         // delete the current gene
         ce_iter ll = upstreamSelect( i );
         ce_iter rr = boost::next( i );
-        len_ -= std::distance( ll, rr );
+        countGene( *i, -1 );
+        uint n = std::distance( ll, rr );
+        len_ -= n;
         i = smart_return( *chro_, ll, rr );
+        elementsErased( std::distance( chro_->begin(), i ), n );
         ++mut_events_[ RM_G ];
         //std::cout << "rmg" << std::endl;
     } else {
@@ -267,7 +502,14 @@ fluke::Chromosome::retroposonMutate( ce_iter i ) {
     if( close_to( cp_tp_rate_ + rm_tp_rate_, 0.0 ) ) {
         return boost::next( i );
     }
-    double uu = uniform();
+    return retroposonMutate( i, uniform() );
+}
+
+fluke::Chromosome::ce_iter
+fluke::Chromosome::retroposonMutate( ce_iter i, double uu ) {
+    if( uu < cp_tp_rate_ + rm_tp_rate_ ) {
+        i = own( i );
+    }
     if( uu < cp_tp_rate_ ) {
         // insert a copy of the retroposon and LTRs somewhere
         Chromosome *aux;
@@ -276,13 +518,20 @@ fluke::Chromosome::retroposonMutate( ce_iter i ) {
         // get the repeats
         ce_iter ll = boost::prior( i );
         ce_iter rr = boost::next( i, 2 );
-        std::list< ChromosomeElement* > cux;
+        ce_scratch cux;
+        cux.reserve( 3 );
         for( ce_iter j = ll; j != rr; ++j ) {
             ChromosomeElement *dux = ( **j ).clone();
             dux->inactivate();
             cux.push_back( dux );
         }
+        // inserting into this chromosome moves the elements behind bux
+        int k = std::distance( chro_->begin(), i );
+        if( aux == this && bux <= i ) {
+            k += 3;
+        }
         aux->splice( bux, cux, 3, 1 );
+        i = chro_->begin() + k;
         ++mut_events_[ CP_RP ];
         //std::cout << "cprp" << std::endl;
         ++i;
@@ -291,8 +540,10 @@ fluke::Chromosome::retroposonMutate( ce_iter i ) {
         ce_iter ll = boost::prior( i );
         ce_iter rr = boost::next( i );
         i = smart_return( *chro_, ll, rr );
+        elementsErased( std::distance( chro_->begin(), i ), 2 );
         // inactivate leftover repeat
         ( **i ).inactivate();
+        inactive_ = true;
         ++mut_events_[ RM_RP ];
         //std::cout << "rmrp" << std::endl;
         --nr_retroposons_;
@@ -304,103 +555,282 @@ fluke::Chromosome::retroposonMutate( ce_iter i ) {
     return i;
 }
 
-std::list< fluke::Chromosome* >
-fluke::Chromosome::segments() {
-    std::list< Chromosome* > result;
+void
+fluke::Chromosome::segments( Genome::chromos_scratch &result ) {
     if( mut_events_[ DSB ] == 0 ) {
         // creating an alias...
         result.push_back( this );
-    } else {
-        // creation of new chromosomes automatically sets their update flag
-        // get the bits and pieces
-        bool found = false;
-        ce_iter jj( chro_->begin() );
-        ce_iter ii( jj );
-        // and loop...
-        while( jj != chro_->end() ) {
-            Repeat *aux = dynamic_cast< Repeat* >( *jj );
-            if( aux ) {
-                if( aux->hasDSB() ) {
-                    aux->repairDSB();
-                    found = true;
-                }
-            }
-            ++jj;
-            // if found, put the segment in the vector
-            if( found ) {
-                /*
-                std::list< ChromosomeElement* > *bux = 
-                    new std::list< ChromosomeElement* >();
-                bux->splice( bux->end(), *chro_, ii, jj );
-                Chromosome *cux = new Chromosome( parent_, bux );
-                */
-                Chromosome *cux = 
-                    ObjectCache< Chromosome >::instance()->borrowObject();
-                cux->parent_ = parent_;
-                cux->chro_->splice( cux->chro_->end(), *chro_, ii, jj );
-                /*
-                std::fill_n( std::back_inserter( cux->mut_events_ ), 6, 0 );
-                */
-                copyRates( *this, *cux );
-                result.push_back( cux );
-                ii = jj;
-                found = false;
-            }
-        }
-        // and the last one
-        /*
-        std::list< ChromosomeElement* > *bux = 
-            new std::list< ChromosomeElement* >();
-        bux->splice( bux->end(), *chro_, ii, jj );
-        Chromosome *cux = new Chromosome( parent_, bux );
-        */
-        Chromosome *cux = 
-            ObjectCache< Chromosome >::instance()->borrowObject();
-        cux->parent_ = parent_;
-        cux->chro_->splice( cux->chro_->end(), *chro_, ii, jj );
-        /*
-        std::fill_n( std::back_inserter( cux->mut_events_ ), 6, 0 );
-        */
-        copyRates( *this, *cux );
-        result.push_back( cux );
-    }
-    // an empty chromosome is the leftover, if there were segments
+        return;
+    }
+#ifdef DEBUG
+    ce_positions aux;
+    for( uint k = 0; k != chro_->size(); ++k ) {
+        if( IsDoubleStrandBreak()( ( *chro_ )[ k ] ) ) aux.push_back( k );
+    }
+    assert( aux == dsbs_ );
+    // a break was made in this pass, so the buffer is ours to cut up
+    assert( chro_.unique() );
+#endif
+    // creation of new chromosomes automatically sets their update flag
+    // cut right behind each break, at the positions recorded, starting 
+    // with the last such that the tails can be split off
+    uint n = result.size();
+    result.resize( n + dsbs_.size() + 1 );
+    for( uint k = dsbs_.size(); k != 0; --k ) {
+        ce_iter jj = chro_->begin() + dsbs_[ k - 1 ];
+        static_cast< Repeat* >( *jj )->repairDSB();
+        result[ n + k ] = piece( boost::next( jj ) );
+    }
+    // and the first one
+    result[ n ] = piece( chro_->begin() );
+    // all elements moved to the segments, an empty chromosome is leftover
+    clear();
+}
+
+fluke::Chromosome*
+fluke::Chromosome::piece( ce_iter first ) {
+    // pre: there are no breaks behind first
+    Chromosome *result = ObjectCache< Chromosome >::instance()->borrowObject();
+    result->parent_ = parent_;
+    uint k = std::distance( chro_->begin(), first );
+    split_off( *chro_, first, *result->chro_ );
+    result->recountGenes();
+    result->inactive_ = inactive_;
+    // the targets go along, only the first element lost its neighbour
+    result->update_targets_ = update_targets_;
+    if( !update_targets_ ) {
+        split_positions( targets_, k, result->targets_ );
+        result->recheckTarget( 0 );
+    }
+    copyRates( *this, *result );
     return result;
 }
 
 void
 fluke::Chromosome::append( Chromosome *chr ) {
     // not copying parent_
-    chro_->splice( chro_->end(), *( chr->chro_ ) );
+    own();
+    chr->own();
+    for( gene_counts::const_iterator i = chr->genes_.begin(); 
+        i != chr->genes_.end(); ++i ) {
+        countGene( i->first, i->second );
+    }
+    uint k = chro_->size();
+    append_positions( dsbs_, chr->dsbs_, k );
+    concatenate( *chro_, *chr->chro_ );
+    inactive_ = inactive_ || chr->inactive_;
+    // the first element of chr has a new neighbour
+    if( update_targets_ || chr->update_targets_ ) {
+        update_targets_ = true;
+    } else {
+        append_positions( targets_, chr->targets_, k );
+        recheckTarget( k );
+    }
+    chr->clear();
     //++mut_events_[ DSB ];
 }
 
 fluke::Chromosome::ce_iter
 fluke::Chromosome::insert( ce_iter i, ChromosomeElement *ce ) {
     ++len_;
-    return chro_->insert( i, ce );
+    countGene( ce, 1 );
+    uint k = std::distance( chro_->begin(), i );
+    i = chro_->insert( i, ce );
+    elementsInserted( k, 1 );
+    return i;
 }
 
 void
 fluke::Chromosome::splice( ce_iter i, 
-    std::list< ChromosomeElement* > ces, uint ll, uint rr ) {
+    const ce_scratch &ces, uint ll, uint rr ) {
     // overloading list method
     len_ += ll;
     nr_retroposons_ += rr;
     nr_ltr_ += 2 * rr;
-    chro_->splice( i, ces );
+    for( ce_scratch::const_iterator j = ces.begin(); j != ces.end(); ++j ) {
+        countGene( *j, 1 );
+    }
+    uint k = std::distance( chro_->begin(), i );
+    chro_->insert( i, ces.begin(), ces.end() );
+    elementsInserted( k, ces.size() );
+    // the copies come in inactive
+    inactive_ = true;
 }
 
 void
 fluke::Chromosome::reset() {
     // pre: chro_ is initialised
-    for( ce_iter i = chro_->begin(); i != chro_->end(); ++i ) {
-        ( **i ).activate();
+    // usually the genome activated us after the last pass, hence no scan
+    activate();
+#ifdef DEBUG
+    for( const_ce_iter i = chro_->begin(); i != chro_->end(); ++i ) {
+        assert( ( **i ).isActive() );
     }
+#endif
     // making sure all entries exist and are zero
     std::fill_n( mut_events_.begin(), 6, 0 );
 }
 
+void
+fluke::Chromosome::activate() {
+    if( !inactive_ ) {
+        return;
+    }
+    // a no-op right after a pass, the inactive elements were written
+    own();
+    for( ce_iter i = chro_->begin(); i != chro_->end(); ++i ) {
+        ( **i ).activate();
+    }
+    inactive_ = false;
+}
+
+void
+fluke::Chromosome::clear() {
+    // others sharing the buffer keep their elements
+    if( chro_.unique() ) {
+        chro_->clear();
+    } else {
+        chro_ = newBuffer();
+    }
+    genes_.clear();
+    dsbs_.clear();
+    update_targets_ = true;
+    interned_ = false;
+    inactive_ = false;
+}
+
+void
+fluke::Chromosome::intern() {
+    if( interned_ ) {
+        return;
+    }
+    // activating our own elements now spares reset() a copy later on
+    activate();
+    hash_ = contentHash( *chro_ );
+    interned_ = true;
+    // buffers we let go of are returned to the pools outside the lock
+    std::vector< shared_container > aux;
+    aux.push_back( chro_ );
+    {
+        boost::mutex::scoped_lock lock( intern_mutex_ );
+        std::pair< intern_table::iterator, intern_table::iterator > bux =
+            interned_buffers_.equal_range( hash_ );
+        for( intern_table::iterator i = bux.first; i != bux.second; ++i ) {
+            if( i->second == chro_ || sameContent( *i->second, *chro_ ) ) {
+                chro_ = i->second;
+                return;
+            }
+        }
+        // forget the buffers only the table holds on to
+        if( interned_buffers_.size() >= intern_sweep_ ) {
+            intern_table::iterator i = interned_buffers_.begin();
+            while( i != interned_buffers_.end() ) {
+                if( i->second.unique() ) {
+                    aux.push_back( i->second );
+                    interned_buffers_.erase( i++ );
+                } else {
+                    ++i;
+                }
+            }
+            intern_sweep_ = std::max< std::size_t >( 1024, 
+                2 * interned_buffers_.size() );
+        }
+        interned_buffers_.insert( std::make_pair( hash_, chro_ ) );
+    }
+}
+
+std::size_t
+fluke::Chromosome::elementHash( const ChromosomeElement *ce ) {
+    std::size_t result = 0;
+    boost::hash_combine( result, static_cast< int >( ce->kind() ) );
+    switch( ce->kind() ) {
+        case ChromosomeElement::BINDING_SITE:
+            boost::hash_combine( result, 
+                static_cast< const BindingSite* >( ce )->tfbs() );
+            break;
+        case ChromosomeElement::TRANSCRIPTION_FACTOR:
+            boost::hash_combine( result, 
+                static_cast< const TranscriptionFactor* >( ce )->transFac() );
+            boost::hash_combine( result, 
+                static_cast< const Downstream* >( ce )->tag() );
+            break;
+        case ChromosomeElement::MODULE_DSTREAM:
+            boost::hash_combine( result, 
+                static_cast< const ModuleDownstream* >( ce )->module() );
+            boost::hash_combine( result, 
+                static_cast< const Downstream* >( ce )->tag() );
+            break;
+        case ChromosomeElement::ORDINARY_DSTREAM:
+        case ChromosomeElement::RETROPOSON:
+            boost::hash_combine( result, 
+                static_cast< const Downstream* >( ce )->tag() );
+            break;
+        case ChromosomeElement::REPEAT:
+            boost::hash_combine( result, 
+                static_cast< const Repeat* >( ce )->hasDSB() );
+            break;
+        default:
+            break;
+    }
+    return result;
+}
+
+bool
+fluke::Chromosome::sameElement( const ChromosomeElement *a, 
+    const ChromosomeElement *b ) {
+    if( a->kind() != b->kind() ) {
+        return false;
+    }
+    switch( a->kind() ) {
+        case ChromosomeElement::BINDING_SITE:
+            return static_cast< const BindingSite* >( a )->tfbs() ==
+                static_cast< const BindingSite* >( b )->tfbs();
+        case ChromosomeElement::TRANSCRIPTION_FACTOR:
+            return static_cast< const TranscriptionFactor* >( a )->transFac()
+                == static_cast< const TranscriptionFactor* >( b )->transFac()
+                && static_cast< const Downstream* >( a )->tag() ==
+                static_cast< const Downstream* >( b )->tag();
+        case ChromosomeElement::MODULE_DSTREAM:
+            return static_cast< const ModuleDownstream* >( a )->module() ==
+                static_cast< const ModuleDownstream* >( b )->module() &&
+                static_cast< const Downstream* >( a )->tag() ==
+                static_cast< const Downstream* >( b )->tag();
+        case ChromosomeElement::ORDINARY_DSTREAM:
+        case ChromosomeElement::RETROPOSON:
+            return static_cast< const Downstream* >( a )->tag() ==
+                static_cast< const Downstream* >( b )->tag();
+        case ChromosomeElement::REPEAT:
+            return static_cast< const Repeat* >( a )->hasDSB() ==
+                static_cast< const Repeat* >( b )->hasDSB();
+        default:
+            return true;
+    }
+}
+
+std::size_t
+fluke::Chromosome::contentHash( const ce_container &c ) {
+    std::size_t result = c.size();
+    for( const_ce_iter i = c.begin(); i != c.end(); ++i ) {
+        boost::hash_combine( result, elementHash( *i ) );
+    }
+    return result;
+}
+
+bool
+fluke::Chromosome::sameContent( const ce_container &a, 
+    const ce_container &b ) {
+    if( a.size() != b.size() ) {
+        return false;
+    }
+    const_ce_iter j = b.begin();
+    for( const_ce_iter i = a.begin(); i != a.end(); ++i, ++j ) {
+        if( !sameElement( *i, *j ) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void
 fluke::Chromosome::recache() {
     update_retro_ = true;
@@ -427,23 +857,128 @@ fluke::Chromosome::upstreamSelect( ce_iter i ) {
 boost::tuple< fluke::Chromosome*, fluke::Chromosome::ce_iter >
 fluke::Chromosome::randChromosomeElement() {
     // pre: chro_ is initialised
-    std::list< ce_iter > aux;
-    ce_iter i = chro_->begin();
-    if( IsTrueDstream()( *i ) || IsBindingSite()( *i ) || IsRepeat()( *i ) ) {
-        aux.push_back( i );
+    // the iterator is used to insert, so the buffer has to be ours
+    own();
+    if( update_targets_ ) {
+        rebuildTargets();
     }
-    ++i;
-    while( i != chro_->end() ) {
-        if( IsTrueDstream()( *i ) || IsBindingSite()( *i ) ) {
-            aux.push_back( i );
-        } else if( IsRepeat()( *i ) && 
-                   !IsRetroposon()( *( boost::prior( i ) ) ) ) {
-            aux.push_back( i );
+#ifdef DEBUG
+    ce_positions aux( targets_ );
+    rebuildTargets();
+    assert( aux == targets_ );
+#endif
+    return boost::make_tuple( this, chro_->begin() + 
+        targets_[ rand_range< int >( targets_.size() ) ] );
+}
+
+void
+fluke::Chromosome::elementsInserted( uint k, uint n ) {
+    // pre: n elements have been inserted at position k
+    shift_positions( dsbs_, k, n );
+    // copies of a broken repeat are broken as well
+    for( uint j = k; j != k + n; ++j ) {
+        if( IsDoubleStrandBreak()( ( *chro_ )[ j ] ) ) {
+            insert_position( dsbs_, j );
         }
-        ++i;
     }
-    return boost::make_tuple( this, 
-        *( random_element( aux.begin(), aux.end(), rand_range< int > ) ) );
+    targetsInserted( k, n );
+}
+
+void
+fluke::Chromosome::elementsErased( uint k, uint n ) {
+    // pre: n elements have been erased at position k
+    erase_positions( dsbs_, k, k + n );
+    shift_positions( dsbs_, k + n, -static_cast< int >( n ) );
+    targetsErased( k, n );
+}
+
+void
+fluke::Chromosome::recordBreak( uint k ) {
+    insert_position( dsbs_, k );
+}
+
+void
+fluke::Chromosome::forgetBreak( uint k ) {
+    erase_positions( dsbs_, k, k + 1 );
+}
+
+bool
+fluke::Chromosome::isTarget( uint k ) const {
+    const ChromosomeElement *aux = ( *chro_ )[ k ];
+    switch( aux->kind() ) {
+        case ChromosomeElement::RETROPOSON:
+        case ChromosomeElement::CENTROMERE:
+            return false;
+        case ChromosomeElement::REPEAT:
+            // not in between a retroposon and its right ltr
+            return k == 0 || !IsRetroposon()( ( *chro_ )[ k - 1 ] );
+        default:
+            return true;
+    }
+}
+
+void
+fluke::Chromosome::recheckTarget( uint k ) {
+    // pre: the targets are up to date, except for the element at k
+    erase_positions( targets_, k, k + 1 );
+    if( k < chro_->size() && isTarget( k ) ) {
+        insert_position( targets_, k );
+    }
+}
+
+void
+fluke::Chromosome::rebuildTargets() {
+    // one pass with iterators, indexing a rope is a search each time
+    targets_.clear();
+    bool retro = false;
+    uint k = 0;
+    for( const_ce_iter i = chro_->begin(); i != chro_->end(); ++i, ++k ) {
+        switch( ( **i ).kind() ) {
+            case ChromosomeElement::RETROPOSON:
+            case ChromosomeElement::CENTROMERE:
+                break;
+            case ChromosomeElement::REPEAT:
+                if( !retro ) targets_.push_back( k );
+                break;
+            default:
+                targets_.push_back( k );
+        }
+        retro = IsRetroposon()( *i );
+    }
+    update_targets_ = false;
+}
+
+void
+fluke::Chromosome::targetsInserted( uint k, uint n ) {
+    // pre: n elements have been inserted at position k
+    if( update_targets_ ) return;
+    // the element that used to be at k has a new neighbour, recheck it
+    erase_positions( targets_, k, k + 1 );
+    shift_positions( targets_, k, n );
+    uint last = std::min( k + n + 1, static_cast< uint >( chro_->size() ) );
+    for( uint j = k; j != last; ++j ) {
+        if( isTarget( j ) ) insert_position( targets_, j );
+    }
+#ifdef DEBUG
+    ce_positions aux( targets_ );
+    rebuildTargets();
+    assert( aux == targets_ );
+#endif
+}
+
+void
+fluke::Chromosome::targetsErased( uint k, uint n ) {
+    // pre: n elements have been erased at position k
+    if( update_targets_ ) return;
+    // drop the erased ones, the element behind them has a new neighbour
+    erase_positions( targets_, k, k + n );
+    shift_positions( targets_, k + n, -static_cast< int >( n ) );
+    recheckTarget( k );
+#ifdef DEBUG
+    ce_positions aux( targets_ );
+    rebuildTargets();
+    assert( aux == targets_ );
+#endif
 }
 
 fluke::Chromosome::tag_container
@@ -452,9 +987,9 @@ fluke::Chromosome::essentialTags() const {
     if( chro_->empty() ) return result;
     
     for( const_ce_iter i = chro_->begin(); i != chro_->end(); ++i ) {
-        OrdinaryDownstream *aux = dynamic_cast< OrdinaryDownstream* >( *i );
-        if( aux /* && IsBindingSite()( *( boost::prior( i ) ) ) */ ) {
-            result.push_back( aux->tag() );
+        if( ( **i ).kind() == ChromosomeElement::ORDINARY_DSTREAM 
+            /* && IsBindingSite()( *( boost::prior( i ) ) ) */ ) {
+            result.push_back( static_cast< OrdinaryDownstream* >( *i )->tag() );
         }
     }
     return result;    
@@ -468,8 +1003,9 @@ fluke::Chromosome::moduleTags( int module ) const {
     if( chro_->empty() ) return result;
     
     for( const_ce_iter i = chro_->begin(); i != chro_->end(); ++i ) {
-        ModuleDownstream *aux = dynamic_cast< ModuleDownstream* >( *i );
-        if( aux /* && IsBindingSite()( *( boost::prior( i ) ) ) */ ) {
+        if( ( **i ).kind() == ChromosomeElement::MODULE_DSTREAM 
+            /* && IsBindingSite()( *( boost::prior( i ) ) ) */ ) {
+            ModuleDownstream *aux = static_cast< ModuleDownstream* >( *i );
             if( aux->module() == module ) {
                 result.push_back( aux->tag() );
             }
@@ -478,6 +1014,48 @@ fluke::Chromosome::moduleTags( int module ) const {
     return result;
 }
 
+void
+fluke::Chromosome::countGene( const ChromosomeElement *ce, int n ) {
+    switch( ce->kind() ) {
+        case ChromosomeElement::ORDINARY_DSTREAM:
+            countGene( gene_key( -1, 
+                static_cast< const OrdinaryDownstream* >( ce )->tag() ), n );
+            break;
+        case ChromosomeElement::MODULE_DSTREAM: {
+            const ModuleDownstream *aux = 
+                static_cast< const ModuleDownstream* >( ce );
+            countGene( gene_key( aux->module(), aux->tag() ), n );
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void
+fluke::Chromosome::countGene( const gene_key &key, int n ) {
+    gene_counts::iterator i = std::lower_bound( genes_.begin(), 
+        genes_.end(), std::make_pair( key, 0u ) );
+    if( i != genes_.end() && i->first == key ) {
+        i->second += n;
+        // only the genes present are listed
+        if( i->second == 0 ) genes_.erase( i );
+    } else {
+#ifdef DEBUG
+        assert( n > 0 );
+#endif
+        genes_.insert( i, std::make_pair( key, static_cast< uint >( n ) ) );
+    }
+}
+
+void
+fluke::Chromosome::recountGenes() {
+    genes_.clear();
+    for( const_ce_iter i = chro_->begin(); i != chro_->end(); ++i ) {
+        countGene( *i, 1 );
+    }
+}
+
 int
 fluke::Chromosome::nrRepeats() const {
     if( update_ltr_ ) {
@@ -497,7 +1075,8 @@ fluke::Chromosome::nrRetroposons() const {
 }
 
 int
-fluke::Chromosome::nrRetroposons( ce_iter first, ce_iter last ) const {
+fluke::Chromosome::nrRetroposons( const_ce_iter first, const_ce_iter last ) 
+    const {
     return std::count_if( first, last, IsRetroposon() );
 }
 
@@ -520,7 +1099,7 @@ void
 fluke::Chromosome::write( std::ostream &os ) const {
     // pre: chro_ is initialised
     os << "<chromosome len=\"" << chro_->size() << "\">\n";
-    ce_iter i = chro_->begin(); 
+    const_ce_iter i = chro_->begin(); 
     while( i != chro_->end() ) {
         os << **i;
         ++i;
@@ -552,6 +1131,8 @@ fluke::Chromosome::copyRates( const Chromosome &s, Chromosome &t ) const {
     t.rm_gene_rate_ = s.rm_gene_rate_;
     // recombination
     t.dsb_recombination_ = s.dsb_recombination_;
+    // sampling
+    t.skip_ahead_ = s.skip_ahead_;
     // and the rates
     t.mut_rate_ = s.mut_rate_;
     t.mut_step_ = s.mut_step_;
@@ -674,3 +1255,63 @@ fluke::Chromosome::dsbStep() const
 void
 fluke::Chromosome::mutationScheme( MutateRates *m )
 { rate_mutator_ = m; }
+
+void
+fluke::Chromosome::skipAhead( bool b )
+{ skip_ahead_ = b; }
+
+bool
+fluke::Chromosome::skipAhead() const
+{ return skip_ahead_; }
+
+void
+fluke::Chromosome::interning( bool b )
+{ interning_ = b; }
+
+bool
+fluke::Chromosome::interning()
+{ return interning_; }
+
+uint
+fluke::Chromosome::nrInterned() {
+    boost::mutex::scoped_lock lock( intern_mutex_ );
+    return interned_buffers_.size();
+}
+
+std::size_t
+fluke::Chromosome::bytes() const {
+    return sizeof( Chromosome ) + heap_bytes( mut_events_ ) + 
+        heap_bytes( genes_ ) + heap_bytes( dsbs_ ) + heap_bytes( targets_ );
+}
+
+std::size_t
+fluke::Chromosome::bufferBytes( const ce_container &c ) {
+    std::size_t result = sizeof( ce_container ) + 
+        c.size() * sizeof( ChromosomeElement* );
+    for( const_ce_iter i = c.begin(); i != c.end(); ++i ) {
+        switch( ( **i ).kind() ) {
+            case ChromosomeElement::BINDING_SITE:
+                result += sizeof( BindingSite );
+                break;
+            case ChromosomeElement::TRANSCRIPTION_FACTOR:
+                result += sizeof( TranscriptionFactor );
+                break;
+            case ChromosomeElement::MODULE_DSTREAM:
+                result += sizeof( ModuleDownstream );
+                break;
+            case ChromosomeElement::ORDINARY_DSTREAM:
+                result += sizeof( OrdinaryDownstream );
+                break;
+            case ChromosomeElement::RETROPOSON:
+                result += sizeof( Retroposon );
+                break;
+            case ChromosomeElement::REPEAT:
+                result += sizeof( Repeat );
+                break;
+            case ChromosomeElement::CENTROMERE:
+                result += sizeof( Centromere );
+                break;
+        }
+    }
+    return result;
+}
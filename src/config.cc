@@ -30,6 +30,20 @@ fluke::Config::Config()
           "height of population grid" )
         ( "shuffle", bo_po::value< std::string >()->default_value( "false" ),
           "shuffle the grid" )
+        ( "update_scheme", 
+          bo_po::value< std::string >()->default_value( "synchronous" ),
+          "population update ( synchronous, tiled, event ); event costs "
+          "about one event per death and per empty cell next to an agent "
+          "in a generation" )
+        ( "threads", bo_po::value< int >()->default_value( 1 ),
+          "# worker threads of the tiled update" )
+        ( "tile_size", bo_po::value< int >()->default_value( 32 ),
+          "edge length of the tiles of the tiled update" )
+        ( "pool_high_water", bo_po::value< int >()->default_value( 16384 ),
+          "max # idle instances kept per kind of pooled object" )
+        ( "intern_chromosomes", 
+          bo_po::value< std::string >()->default_value( "false" ),
+          "share equal chromosomes across the population" )
         ( "sum_fitness_threshold", 
           bo_po::value< double >()->default_value( 1.0 ),
           "threshold for probalistic reproduction [ 0.0, 8.0 )" )
@@ -98,6 +112,10 @@ fluke::Config::Config()
           "geno distances in csv filename" )
         ( "log_genes_csv", bo_po::value< std::string >(),
           "gene numbers in csv filename" )
+        ( "log_sharing_csv", bo_po::value< std::string >(),
+          "shared chromosome memory in csv filename" )
+        ( "log_memory_csv", bo_po::value< std::string >(),
+          "memory footprint per subsystem in csv filename" )
         ( "log_environ_csv", bo_po::value< std::string >(),
           "environment change in csv filename" )
         ( "log_population_csv", bo_po::value< std::string >(),
@@ -195,6 +213,9 @@ fluke::Config::Config()
         ( "mutate_scheme", 
           bo_po::value< std::string >()->default_value( "fixed" ),
           "mutate rates differently" )
+        ( "mutate_sampling", 
+          bo_po::value< std::string >()->default_value( "element" ),
+          "sample mutations per element or skip ahead ( element, skip )" )
         ( "uniform_low", bo_po::value< double >(), 
           "lower bound for uniform mutation" )
         ( "uniform_high", bo_po::value< double >(), 
@@ -95,7 +95,7 @@ fluke::Factory::chromosome( int type ) {
     // scan list and flank all retroposons with repeats
     // scan list and add bsites to the downstreams
     int nr_bs = conf_->optionAsInt( "bsites", type );
-    Chromosome::ce_iter i = ll->begin();
+    std::list< ChromosomeElement* >::iterator i = ll->begin();
     while( i != ll->end() ) {
         if( Chromosome::IsRetroposon()( *i ) ) {
             ll->insert( i, repeat() );
@@ -126,6 +126,8 @@ fluke::Factory::chromosome( int type ) {
     result->retroStep( conf_->optionAsDouble( "retro_step", type ) );
     result->mutationRate( conf_->optionAsDouble( "mut_rate", type ) );
     result->mutationScheme( mutateRates( type ) );
+    result->skipAhead( 
+        conf_->optionAsString( "mutate_sampling", type ) == "skip" );
     return result;
 }
 
@@ -165,6 +167,12 @@ fluke::Factory::population() {
     Population::nrAgentTypes( conf_->optionAsInt( "nr_agent_type" ) );
     Population::placement( conf_->optionAsString( "agent_placement" ) );
     Population::shuffling( conf_->optionAsString( "shuffle" ) == "true" );
+    Population::updateScheme( conf_->optionAsString( "update_scheme" ) );
+    Population::nrThreads( conf_->optionAsInt( "threads" ) );
+    Population::tileSize( conf_->optionAsInt( "tile_size" ) );
+    Chromosome::interning( 
+        conf_->optionAsString( "intern_chromosomes" ) == "true" );
+    ObjectCacheBase::highWaterMark( conf_->optionAsInt( "pool_high_water" ) );
     Population::threshold( conf_->optionAsDouble( "sum_fitness_threshold" ) );
     // and per agent type stuff
     readAgentConfigurations();
@@ -580,7 +588,7 @@ fluke::Factory::organiseChromosome(
     parts->pop_back();
     // add repeats
     int aux = 2 * parts->size();
-    Chromosome::ce_iter i = ltr.begin();
+    std::list< ChromosomeElement* >::iterator i = ltr.begin();
     while( i != ltr.end() ) {
         int bux = static_cast< int >( aux * uniform() );
         if( bux % 2 == 0 ) {
@@ -618,8 +626,9 @@ fluke::Factory::organiseChromosome(
         // take out elements
         std::list< ChromosomeElement* > bux;
         for( int i = 0; i < nr_elem; ++i ) {
-            Chromosome::ce_iter cux = boost::next( result->begin(), 
-                static_cast< int >( aux * uniform() ) );
+            std::list< ChromosomeElement* >::iterator cux = 
+                boost::next( result->begin(), 
+                    static_cast< int >( aux * uniform() ) );
             bux.push_back( *cux );
             result->erase( cux );
             --aux;
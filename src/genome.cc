@@ -8,18 +8,24 @@
 #include "chromosome.hh"
 #include "chromelement.hh"
 
-fluke::Genome::Genome() : chromos_( new std::list< Chromosome* >() ),
+template<> fluke::ObjectCache< fluke::Genome >* 
+fluke::ObjectCache< fluke::Genome >::instance_ = 0;
+
+fluke::Genome::Genome() : chromos_( new chromos_container() ),
     nr_dsbs_parent_(), nr_mutations_() {}
 
 // note: using magic number
 fluke::Genome::Genome( std::list< Chromosome* > *c ) 
-: chromos_( c ), nr_dsbs_parent_( 2 * c->size(), 0 ), nr_mutations_( 6, 0 ) {
+: chromos_( new chromos_container( c->begin(), c->end() ) ), 
+  nr_dsbs_parent_( 2 * c->size(), 0 ), nr_mutations_( 6, 0 ) {
+    delete c;
     for( chromos_iter i = chromos_->begin(); i != chromos_->end(); ++i ) {
         ( **i ).parent( this );
     }
 }
 
-fluke::Genome::Genome( const Genome &g ) : nr_dsbs_parent_(), nr_mutations_() {
+fluke::Genome::Genome( const Genome &g ) : chromos_( new chromos_container() ),
+    nr_dsbs_parent_(), nr_mutations_() {
     Genome::copy( g );
 }
 
@@ -30,58 +36,112 @@ fluke::Genome::~Genome() {
 
 fluke::Genome*
 fluke::Genome::clone() const {
-    return new Genome( *this );
+    Genome *result = ObjectCache< Genome >::instance()->borrowObject();
+    result->copy( *this );
+    return result;
 }
 
 void
 fluke::Genome::copy( const Genome &g ) {
-    chromos_ = new std::list< Chromosome* >();
+    // pre: \c this is empty
     for( chromos_iter i = g.chromos_->begin(); i != g.chromos_->end(); ++i ) {
         //chromos_->push_back( new Chromosome( **i ) );
         chromos_->push_back( ( **i ).clone() );
         chromos_->back()->parent( this );
     }
-    std::copy( g.nr_dsbs_parent_.begin(), g.nr_dsbs_parent_.end(),
-        std::back_inserter( nr_dsbs_parent_ ) );
-    std::copy( g.nr_mutations_.begin(), g.nr_mutations_.end(),
-        std::back_inserter( nr_mutations_ ) );
+    nr_dsbs_parent_.assign( g.nr_dsbs_parent_.begin(), 
+        g.nr_dsbs_parent_.end() );
+    nr_mutations_.assign( g.nr_mutations_.begin(), g.nr_mutations_.end() );
+}
+
+void
+fluke::Genome::toPool() {
+    clear();
+    nr_dsbs_parent_.clear();
+    nr_mutations_.clear();
+    ObjectCache< Genome >::instance()->returnObject( this );
 }
 
+void*
+fluke::Genome::operator new( std::size_t n ) 
+{ return ObjectCache< Genome >::instance()->allocate( n ); }
+
+void
+fluke::Genome::operator delete( void *p, std::size_t n ) 
+{ ObjectCache< Genome >::instance()->deallocate( p, n ); }
+
 void
 fluke::Genome::duplicate() {
-    std::list< Chromosome* > aux;
-    for( chromos_iter i = chromos_->begin(); i != chromos_->end(); ++i ) {
-        //aux.push_back( new Chromosome( **i ) );
-        aux.push_back( ( **i ).clone() );
+    // append the clones right away, only visiting the originals
+    uint n = chromos_->size();
+    chromos_->reserve( 2 * n );
+    for( uint k = 0; k < n; ++k ) {
+        //chromos_->push_back( new Chromosome( **i ) );
+        chromos_->push_back( ( *chromos_ )[ k ]->clone() );
     }
-    chromos_->splice( chromos_->end(), aux );
 }
 
+// note: using magic number
 fluke::Genome*
 fluke::Genome::split() {
     // note: assuming only two chromosomes
-    std::list< Chromosome* > *aux = new std::list< Chromosome* >();
-    aux->splice( aux->begin(), *chromos_, boost::next( chromos_->begin() ) );
-    Genome *result = new Genome( aux );
-    std::copy( nr_dsbs_parent_.begin(), nr_dsbs_parent_.end(),
-        result->nr_dsbs_parent_.begin() );
-    std::copy( nr_mutations_.begin(), nr_mutations_.end(),
-        result->nr_mutations_.begin() );
+    // the second chromosome moves to the sister
+    Genome *result = ObjectCache< Genome >::instance()->borrowObject();
+    chromos_iter aux = boost::next( chromos_->begin() );
+    result->chromos_->push_back( *aux );
+    chromos_->erase( aux );
+    result->chromos_->back()->parent( result );
+    // the counts of the parent, as far as they fit
+    result->nr_dsbs_parent_.assign( nr_dsbs_parent_.begin(), 
+        nr_dsbs_parent_.begin() + std::min< std::size_t >( 2, 
+        nr_dsbs_parent_.size() ) );
+    result->nr_dsbs_parent_.resize( 2, 0 );
+    result->nr_mutations_.assign( nr_mutations_.begin(), 
+        nr_mutations_.end() );
     return result;
 }
 
+fluke::Genome*
+fluke::Genome::replicate() {
+    // the copies are mutated together with the originals, such that copied
+    // genes may land in either daughter; after which the first chromosome
+    // stays and the rest forms the sister genome.
+    // A copy shares the buffer of its original (see Chromosome::own), and
+    // the buffers are left active after each pass. Hence a chromosome 
+    // without events is never copied, only the ones that are written to 
+    // clone their elements, once.
+    duplicate();
+    mutate();
+    if( Chromosome::interning() ) {
+        for( chromos_iter i = chromos_->begin(); i != chromos_->end(); ++i ) {
+            ( **i ).intern();
+        }
+    }
+    return split();
+}
+
 int 
 fluke::Genome::mutate() {
+    // the temporaries of mutation and recombination
+    ScratchScope scope;
     int result = 0;
     for( chromos_iter i = chromos_->begin(); i != chromos_->end(); ++i ) {
         ( **i ).mutate();
     }
+    // copies inserted into a chromosome, possibly from the other ones, are
+    // inactive until the pass of the whole genome is over. Activate them
+    // while the buffers are still ours alone, such that the next pass does
+    // not copy a buffer just to activate it
+    for( chromos_iter i = chromos_->begin(); i != chromos_->end(); ++i ) {
+        ( **i ).activate();
+    }
     // Gather a few counts, first clear
     nr_dsbs_parent_.clear();
     std::fill( nr_mutations_.begin(), nr_mutations_.end(), 0 );
+    uint nr_dsbs = 0;
     for( chromos_iter i = chromos_->begin(); i != chromos_->end(); ++i ) {
         // genes
-        std::vector< uint > aux = ( **i ).nrMutations();
+        const std::vector< uint > &aux = ( **i ).nrMutations();
         // might be empty if a cached version is taken...
         if( ! aux.empty() ) {
             std::transform( nr_mutations_.begin(), nr_mutations_.end(),
@@ -89,33 +149,31 @@ fluke::Genome::mutate() {
         }
         // dsbs
         nr_dsbs_parent_.push_back( ( **i ).nrDoubleStrandBreaks() );
+        nr_dsbs += nr_dsbs_parent_.back();
+    }
+    // no breaks, every chromosome is a segment of its own: done
+    if( nr_dsbs == 0 ) {
+        return result;
     }
     
-    // get all segments
-    std::list< Chromosome* > recombined;
-    std::vector< Chromosome* > heads, middles, tails;
+    // get all segments, the chromosomes cut themselves at their breaks
+    chromos_scratch recombined, heads, middles, tails, aux;
+    recombined.reserve( chromos_->size() );
     heads.reserve( chromos_->size() );
     tails.reserve( chromos_->size() );
-    chromos_iter i = chromos_->begin();
-    while( i != chromos_->end() ) {
-        // get the segments
-        std::list< Chromosome* > aux = ( **i ).segments();
+    for( chromos_iter i = chromos_->begin(); i != chromos_->end(); ++i ) {
+        aux.clear();
+        ( **i ).segments( aux );
         // do something depending on # segments
         if( aux.size() == 1 ) {
             recombined.push_back( aux.front() );
-        } else if( aux.size() == 2 ) {
-            heads.push_back( aux.front() );
-            tails.push_back( aux.back() );
         } else {
-            middles.reserve( middles.size() + aux.size() - 2 );
             heads.push_back( aux.front() );
             tails.push_back( aux.back() );
             // and all the middle parts
-            std::copy( boost::next( aux.begin() ), boost::prior( aux.end() ),
-                std::back_inserter( middles ) );
+            middles.insert( middles.end(), boost::next( aux.begin() ), 
+                boost::prior( aux.end() ) );
         }
-        aux.clear();
-        ++i;
     }
 
     // try to reuse these...
@@ -126,7 +184,7 @@ fluke::Genome::mutate() {
 
     // randomly assign middle segments to heads
     std::random_shuffle( middles.begin(), middles.end(), rand_range< int > );
-    for( std::vector< Chromosome* >::iterator i = middles.begin(); 
+    for( chromos_scratch::iterator i = middles.begin(); 
         i != middles.end(); ++i ) {
         Chromosome *aux = *( random_element( heads.begin(),
              heads.end(), rand_range< int > ) );
@@ -137,25 +195,22 @@ fluke::Genome::mutate() {
 
     // randomly assign the last part of the chromosomes
     std::random_shuffle( tails.begin(), tails.end(), rand_range< int > );
-    for( std::vector< Chromosome* >::iterator i = heads.begin(); 
+    for( chromos_scratch::iterator i = heads.begin(); 
         i != heads.end(); ++i ) {
         ( **i ).append( tails.back() );
-        delete tails.back();
+        tails.back()->toPool();
         tails.pop_back();
     }
 
     // make them recache their info
-    for( std::vector< Chromosome* >::iterator i = heads.begin(); 
+    for( chromos_scratch::iterator i = heads.begin(); 
         i != heads.end(); ++i ) {
         ( **i ).recache();
     }
 
     // and copy the new ones 
-    chromos_->clear();
-    chromos_->splice( chromos_->begin(), recombined );
-    std::copy( heads.begin(), heads.end(), std::back_inserter(
-            *chromos_ ) );
-    heads.clear();
+    chromos_->assign( recombined.begin(), recombined.end() );
+    chromos_->insert( chromos_->end(), heads.begin(), heads.end() );
 
     return result; 
 }
@@ -182,8 +237,42 @@ fluke::Genome::moduleTags( int module ) const {
     return result;
 }
 
+void
+fluke::Genome::geneCounts( Chromosome::gene_scratch &result ) const {
+    result.clear();
+    Chromosome::gene_scratch bux;
+    for( chromos_iter i = chromos_->begin(); i != chromos_->end(); ++i ) {
+        const Chromosome::gene_counts &aux = ( **i ).geneCounts();
+        if( result.empty() ) {
+            result.assign( aux.begin(), aux.end() );
+            continue;
+        }
+        // merge two sorted count vectors, adding up equal genes
+        bux.clear();
+        bux.reserve( result.size() + aux.size() );
+        Chromosome::gene_scratch::const_iterator j = result.begin();
+        Chromosome::gene_counts::const_iterator k = aux.begin();
+        while( j != result.end() && k != aux.end() ) {
+            if( j->first < k->first ) {
+                bux.push_back( *j++ );
+            } else if( k->first < j->first ) {
+                bux.push_back( *k++ );
+            } else {
+                bux.push_back( std::make_pair( j->first, 
+                    j->second + k->second ) );
+                ++j;
+                ++k;
+            }
+        }
+        bux.insert( bux.end(), j, Chromosome::gene_scratch::const_iterator( 
+            result.end() ) );
+        bux.insert( bux.end(), k, aux.end() );
+        result.swap( bux );
+    }
+}
+
 boost::tuple< fluke::Chromosome*, 
-    std::list< fluke::ChromosomeElement* >::iterator >
+    fluke::Chromosome::ce_iter >
 fluke::Genome::randElement() {
     Chromosome *bux = *( random_element( chromos_->begin(), chromos_->end(),
         rand_range< int > ) );
@@ -214,6 +303,17 @@ fluke::Genome::clear() {
     smart_return( *chromos_, chromos_->begin(), chromos_->end() );
 }
 
+std::size_t
+fluke::Genome::bytes() const {
+    std::size_t result = sizeof( Genome ) + sizeof( chromos_container ) + 
+        heap_bytes( *chromos_ ) + heap_bytes( nr_dsbs_parent_ ) + 
+        heap_bytes( nr_mutations_ );
+    for( chromos_iter i = chromos_->begin(); i != chromos_->end(); ++i ) {
+        result += ( **i ).bytes();
+    }
+    return result;
+}
+
 int
 fluke::Genome::nrRetroposons() const {
     int result = 0;
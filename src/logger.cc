@@ -12,6 +12,7 @@
 #include "retroposon.hh"
 #include "downstream.hh"
 #include "bsite.hh"
+#include "transfac.hh"
 #include "environment.hh"
 #include "duo_agent.hh"
 
@@ -74,7 +75,7 @@ fluke::LogCsvMutations::update( Subject *s ) {
         // dsbs per chromosome d = dsb
         boost::tie( da, db ) = m1->nrDsbParent();
         // other mutations c = copy, r = remove
-        std::vector< uint > mm( m1->nrMutations() );
+        const std::vector< uint > &mm = m1->nrMutations();
         c1 = mm[ Chromosome::CP_G ];
         r1 = mm[ Chromosome::RM_G ];
         // length differences
@@ -269,7 +270,7 @@ fluke::LogCsvGenes::LogCsvGenes(
 void
 fluke::LogCsvGenes::doUpdate( Subject *s ) {
     Population *pop = static_cast< Population * >( s );
-    Population::agents_map am = pop->map();
+    const Population::agents_map &am = pop->map();
 
     // first find out dimensions
     uint mod = 0;
@@ -282,7 +283,8 @@ fluke::LogCsvGenes::doUpdate( Subject *s ) {
     std::vector< std::vector< uint > > genes( mod );
     
     // fill vector
-    for( Population::map_ag_iter i = am.begin(); i != am.end(); ++i ) {
+    for( Population::const_map_ag_iter i = am.begin(); i != am.end(); 
+        ++i ) {
         // counting genes in module agents
         ModuleAgent *ma = dynamic_cast< ModuleAgent* >( i->first );
         if( ma ) {
@@ -337,6 +339,134 @@ fluke::LogCsvGenes::writeHeader() {
     *log_ << "# max, mean, median, variance per essential and module genes\n";
 }
 
+//
+// Simple csv observer for the chromosome buffers shared in the population
+//
+fluke::LogCsvSharing::LogCsvSharing( 
+        std::string fname, StreamManager *s, long i ) : LogObserver( s, i ) {
+    openLog( fname );
+    writeHeader();
+}
+
+void
+fluke::LogCsvSharing::doUpdate( Subject *s ) {
+    Population *pop = static_cast< Population * >( s );
+    const Population::agents_map &am = pop->map();
+
+    // count the chromosomes holding each buffer
+    std::map< const Chromosome::ce_container *, uint > holders;
+    uint nr_chromos = 0, nr_refs = 0;
+    for( Population::const_map_ag_iter i = am.begin(); i != am.end(); 
+        ++i ) {
+        ModuleAgent *ma = dynamic_cast< ModuleAgent* >( i->first );
+        if( ma ) {
+            const Genome::chromos_container &aux = 
+                ma->genome().chromosomes();
+            for( Genome::const_chromos_iter j = aux.begin(); j != aux.end();
+                ++j ) {
+                ++holders[ &( **j ).elements() ];
+                nr_refs += ( **j ).elements().size();
+                ++nr_chromos;
+            }
+        }
+    }
+    // the memory saved by sharing: all but the first holder of a buffer
+    uint nr_elements = 0;
+    std::size_t shared = 0;
+    for( std::map< const Chromosome::ce_container *, uint >::iterator 
+        i = holders.begin(); i != holders.end(); ++i ) {
+        nr_elements += i->first->size();
+        shared += ( i->second - 1 ) * Chromosome::bufferBytes( *i->first );
+    }
+    *log_ << nr_chromos << " " << holders.size() << " " << nr_refs << " " 
+        << nr_elements << " " << Chromosome::nrInterned() << " " 
+        << shared << std::endl;
+}
+
+void
+fluke::LogCsvSharing::writeHeader() {
+    *log_ << "# chromosomes, buffers, elements referenced, elements stored, "
+        << "interned buffers, bytes shared\n";
+}
+
+//
+// Footprint of the subsystems, in objects and bytes
+//
+fluke::LogCsvMemory::LogCsvMemory( 
+        std::string fname, StreamManager *s, long i ) : LogObserver( s, i ) {
+    openLog( fname );
+    writeHeader();
+}
+
+void
+fluke::LogCsvMemory::doUpdate( Subject *s ) {
+    Population *pop = static_cast< Population * >( s );
+    const Population::agents_map &am = pop->map();
+
+    // agents and their genomes, a shared buffer is counted once
+    std::set< const Chromosome::ce_container * > buffers;
+    uint nr_genomes = 0, nr_chromos = 0, nr_elements = 0;
+    std::size_t agent_bytes = 0, genome_bytes = 0, element_bytes = 0;
+    for( Population::const_map_ag_iter i = am.begin(); i != am.end(); 
+        ++i ) {
+        agent_bytes += i->first->bytes();
+        ModuleAgent *ma = dynamic_cast< ModuleAgent* >( i->first );
+        if( ma ) {
+            ++nr_genomes;
+            genome_bytes += ma->genome().bytes();
+            const Genome::chromos_container &aux = 
+                ma->genome().chromosomes();
+            for( Genome::const_chromos_iter j = aux.begin(); j != aux.end();
+                ++j ) {
+                ++nr_chromos;
+                const Chromosome::ce_container &bux = ( **j ).elements();
+                if( buffers.insert( &bux ).second ) {
+                    nr_elements += bux.size();
+                    element_bytes += Chromosome::bufferBytes( bux );
+                }
+            }
+        }
+    }
+    // instances and free slots waiting in the pools
+    uint nr_idle = 0;
+    std::size_t idle_bytes = 0;
+    const std::vector< ObjectCacheBase* > &caches = ObjectCacheBase::caches();
+    for( std::vector< ObjectCacheBase* >::const_iterator i = caches.begin();
+        i != caches.end(); ++i ) {
+        nr_idle += ( **i ).getNrIdle();
+        idle_bytes += ( **i ).getNrIdleBytes();
+    }
+    // short sequence tables of binding sites and transcription factors
+    std::size_t seq_bytes = 0;
+    if( BindingSite::shortSeqManager() != 0 ) {
+        seq_bytes += BindingSite::shortSeqManager()->bytes();
+    }
+    if( TranscriptionFactor::shortSeqManager() != 0 ) {
+        seq_bytes += TranscriptionFactor::shortSeqManager()->bytes();
+    }
+    std::size_t grid_bytes = pop->gridBytes();
+    std::size_t index_bytes = pop->indexBytes();
+    std::size_t scratch_bytes = ScratchArena::totalCapacity();
+
+    *log_ << am.size() << " " << agent_bytes << " " 
+        << nr_genomes << " " << genome_bytes << " " 
+        << nr_chromos << " " << buffers.size() << " " 
+        << nr_elements << " " << element_bytes << " " 
+        << grid_bytes << " " << index_bytes << " " << seq_bytes << " " 
+        << nr_idle << " " << idle_bytes << " " << scratch_bytes << " " 
+        << agent_bytes + genome_bytes + element_bytes + grid_bytes + 
+            index_bytes + seq_bytes + idle_bytes + scratch_bytes 
+        << std::endl;
+}
+
+void
+fluke::LogCsvMemory::writeHeader() {
+    *log_ << "# agents, agent bytes, genomes, genome bytes, chromosomes, "
+        << "buffers, elements, element bytes, grid bytes, index bytes, "
+        << "short seq bytes, idle pooled, idle pool bytes, scratch bytes, "
+        << "total bytes\n";
+}
+
 //
 // Simple csv observer for tracking the evolving rates
 //
@@ -349,11 +479,12 @@ fluke::LogCsvRates::LogCsvRates(
 void
 fluke::LogCsvRates::doUpdate( Subject *s ) {
     Population *pop = static_cast< Population * >( s );
-    Population::agents_map am = pop->map();
+    const Population::agents_map &am = pop->map();
 
     // fill vector
     std::vector< std::vector< double > > rts( 6, std::vector< double >() );
-    for( Population::map_ag_iter i = am.begin(); i != am.end(); ++i ) {
+    for( Population::const_map_ag_iter i = am.begin(); i != am.end(); 
+        ++i ) {
         // getting mutation rate values in module agents
         ModuleAgent *ma = dynamic_cast< ModuleAgent* >( i->first );
         if( ma ) {
@@ -409,12 +540,13 @@ fluke::LogCsvPrunedDist::LogCsvPrunedDist(
 void
 fluke::LogCsvPrunedDist::doUpdate( Subject *s ) {
     Population *pop = static_cast< Population * >( s );
-    Population::agents_map am = pop->map();
+    const Population::agents_map &am = pop->map();
 
     // get all the distances
     int max_dist = ModuleAgent::maxDistance(); 
     std::vector< double > distances;
-    for( Population::map_ag_iter i = am.begin(); i != am.end(); ++i ) {
+    for( Population::const_map_ag_iter i = am.begin(); i != am.end(); 
+        ++i ) {
         double aux = i->first->distance();
         if( aux < max_dist ) {
             distances.push_back( aux );
@@ -469,11 +601,12 @@ fluke::LogCsvDistances::LogCsvDistances(
 void
 fluke::LogCsvDistances::doUpdate( Subject *s ) {
     Population *pop = static_cast< Population * >( s );
-    Population::agents_map am = pop->map();
+    const Population::agents_map &am = pop->map();
 
     // get all the distances
     std::vector< double > distances;
-    for( Population::map_ag_iter i = am.begin(); i != am.end(); ++i ) {
+    for( Population::const_map_ag_iter i = am.begin(); i != am.end(); 
+        ++i ) {
         distances.push_back( i->first->distance() );
     }
     
@@ -526,11 +659,12 @@ fluke::LogCsvScores::LogCsvScores(
 void
 fluke::LogCsvScores::doUpdate( Subject *s ) {
     Population *pop = static_cast< Population * >( s );
-    Population::agents_map am = pop->map();
+    const Population::agents_map &am = pop->map();
 
     // get all the scores
     std::vector< double > scores;
-    for( Population::map_ag_iter i = am.begin(); i != am.end(); ++i ) {
+    for( Population::const_map_ag_iter i = am.begin(); i != am.end(); 
+        ++i ) {
         scores.push_back( i->first->score() );
     }
     
@@ -646,7 +780,7 @@ fluke::LogXmlAgentTrace::update( Subject *s ) {
         writeHeader();
         int aa, ab;
         boost::tie( aa, ab ) = ag->nrDsbParent();
-        std::vector< uint > bb( ag->nrMutations() );
+        const std::vector< uint > &bb = ag->nrMutations();
         *log_ << "<mutations dsb_a=\"" << aa
             << "\" dsb_b=\"" << ab 
             << "\" cp_g=\"" << bb[ Chromosome::CP_G ] 
@@ -692,14 +826,15 @@ fluke::LogXmlGenomes::LogXmlGenomes(
 void
 fluke::LogXmlGenomes::doUpdate( Subject *s ) {
     Population *pop = static_cast< Population * >( s );
-    Population::agents_map am = pop->map();
+    const Population::agents_map &am = pop->map();
 
     // begin of file
     openLog( unique_name( pop->generation() ) );
     writeHeader();
     *log_ << "<generation time=\"" << pop->generation() << "\">\n";
 
-    for( Population::map_ag_iter i = am.begin(); i != am.end(); ++i ) {
+    for( Population::const_map_ag_iter i = am.begin(); i != am.end(); 
+        ++i ) {
         // output the genome agents
         *log_ << *( i->first );
     }
@@ -744,13 +879,14 @@ fluke::LogXmlEnvGenomes::LogXmlEnvGenomes( std::string dname, StreamManager *s )
 void
 fluke::LogXmlEnvGenomes::update( Subject *s ) {
     Population *pop = static_cast< Population * >( s );
-    Population::agents_map am = pop->map();
+    const Population::agents_map &am = pop->map();
     // begin of file
     openLog( unique_name( pop->generation() ) );
     writeHeader();
     *log_ << "<generation time=\"" << pop->generation() << "\">\n";
 
-    for( Population::map_ag_iter i = am.begin(); i != am.end(); ++i ) {
+    for( Population::const_map_ag_iter i = am.begin(); i != am.end(); 
+        ++i ) {
         // output the genome agents
         *log_ << *( i->first );
     }
@@ -794,11 +930,12 @@ fluke::LogPopulationSize::LogPopulationSize(
 void
 fluke::LogPopulationSize::doUpdate( Subject *s ) {
     Population *pop = static_cast< Population * >( s );
-    Population::agents_map am = pop->map();
+    const Population::agents_map &am = pop->map();
 
     // get all the scores
     std::map< int, int > subpop;
-    for( Population::map_ag_iter i = am.begin(); i != am.end(); ++i ) {
+    for( Population::const_map_ag_iter i = am.begin(); i != am.end(); 
+        ++i ) {
         int aux = i->first->type();
         ++subpop[ aux /* + 1 */ ];
     }
@@ -830,12 +967,13 @@ fluke::LogCsvPopulationDistances::LogCsvPopulationDistances(
 void
 fluke::LogCsvPopulationDistances::doUpdate( Subject *s ) {
     Population *pop = static_cast< Population * >( s );
-    Population::agents_map am = pop->map();
+    const Population::agents_map &am = pop->map();
 
     // get all the scores
     std::vector< double > scores_one;
     std::vector< double > scores_two;
-    for( Population::map_ag_iter i = am.begin(); i != am.end(); ++i ) {
+    for( Population::const_map_ag_iter i = am.begin(); i != am.end(); 
+        ++i ) {
         if( i->first->type() == 1 ) {
             scores_one.push_back( i->first->distance() );
         } else if( i->first->type() == 2 ) {
@@ -919,7 +1057,7 @@ fluke::LogCsvGrid::LogCsvGrid(
 void
 fluke::LogCsvGrid::doUpdate( Subject *s ) {
     Population *pop = static_cast< Population * >( s );
-    Population::agents_grid grid = pop->grid();
+    const Population::agents_grid &grid = pop->grid();
     
     // begin of file
     openLog( unique_name( pop->generation() ) );
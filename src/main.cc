@@ -16,7 +16,7 @@ using namespace fluke;
 
 // globals...
 base_generator_type fluke::generator( 18 );
-uniform_gen_type fluke::uniform( fluke::generator );
+UniformStream fluke::uniform( fluke::generator );
 
 int
 main( int argc, char **argv ) {
@@ -30,7 +30,7 @@ main( int argc, char **argv ) {
 #ifdef DEBUG
         std::cout << "Timing: " << tt.elapsed() << " seconds\n";
 #endif
-    } catch( char *e ) {
+    } catch( const char *e ) {
         std::cout << "Exception: " << e << std::endl;
     } catch( exception &e ) {
         std::cout << "Exception: " << e.what() << std::endl;
@@ -138,6 +138,16 @@ fluke::Model::observe() {
             new LogCsvGenes( aux.optionAsString( "log_genes_csv" ),
             &( fluke_->streamManager() ), aux.optionAsLong( "log_period" ) ) );
     }
+    if( aux.hasOption( "log_sharing_csv" ) ) {
+        observers_->subscribe( poppy_, 
+            new LogCsvSharing( aux.optionAsString( "log_sharing_csv" ),
+            &( fluke_->streamManager() ), aux.optionAsLong( "log_period" ) ) );
+    }
+    if( aux.hasOption( "log_memory_csv" ) ) {
+        observers_->subscribe( poppy_, 
+            new LogCsvMemory( aux.optionAsString( "log_memory_csv" ),
+            &( fluke_->streamManager() ), aux.optionAsLong( "log_period" ) ) );
+    }
     if( aux.hasOption( "log_pruned_dist_csv" ) ) {
         observers_->subscribe( poppy_, 
             new LogCsvPrunedDist( aux.optionAsString( "log_pruned_dist_csv" ),
@@ -8,6 +8,13 @@
 #include "population.hh"
 #include "environment.hh"
 
+template<> fluke::ObjectCache< fluke::ModuleAgent >* 
+fluke::ObjectCache< fluke::ModuleAgent >::instance_ = 0;
+
+// the flags sit in the tail padding of Agent
+BOOST_STATIC_ASSERT( sizeof( fluke::ModuleAgent ) <= sizeof( fluke::Agent ) + 
+    4 * sizeof( int ) + sizeof( void* ) + sizeof( double ) + 
+    2 * sizeof( std::vector< int > ) );
 
 float fluke::ModuleAgent::birth_rate_ = 0.0;
 float fluke::ModuleAgent::death_rate_ = 0.0;
@@ -28,19 +35,52 @@ fluke::ModuleAgent::essential_tags_ = Chromosome::tag_container();
 
 fluke::ModuleAgent::ModuleAgent( int tt, Genome *g ) 
     : Agent( tt ), mod_tags_now_(), ess_tags_now_() {
-    genome_ = g;
-    distance_ = 0;
-    distance_parent_ = 0;
-    size_parent_ = genome_->fullSize();
-    inventorised_ = false;
+    reborn( tt, g );
 }
 
 fluke::ModuleAgent::ModuleAgent( const ModuleAgent &ag ) : Agent() {
     ModuleAgent::copy( ag );
 }
 
+fluke::ModuleAgent::ModuleAgent() 
+    : Agent(), inventorised_( false ), distance_( 0 ), distance_parent_( 0 ),
+      size_parent_( 0 ), genome_( 0 ), score_( 0.0 ), mod_tags_now_(), 
+      ess_tags_now_() {}
+
 fluke::ModuleAgent::~ModuleAgent() {
-    delete genome_;
+    // idle agents in the pool have no genome
+    if( genome_ != 0 ) genome_->toPool();
+}
+
+void*
+fluke::ModuleAgent::operator new( std::size_t n ) 
+{ return ObjectCache< ModuleAgent >::instance()->allocate( n ); }
+
+void
+fluke::ModuleAgent::operator delete( void *p, std::size_t n ) 
+{ ObjectCache< ModuleAgent >::instance()->deallocate( p, n ); }
+
+void
+fluke::ModuleAgent::toPool() {
+    // the gene counts stay, a sibling overwrites them
+    genome_->toPool();
+    genome_ = 0;
+    inventorised_ = false;
+    ObjectCache< ModuleAgent >::instance()->returnObject( this );
+}
+
+void
+fluke::ModuleAgent::reborn( int tt, Genome *g ) {
+    me_ = ancestor_ = AgentTag().pack();
+    type_ = tt;
+    slot_[ 0 ] = slot_[ 1 ] = -1;
+    dying_ = false;
+    genome_ = g;
+    distance_ = 0;
+    distance_parent_ = 0;
+    size_parent_ = genome_->fullSize();
+    inventorised_ = false;
+    score_ = fitness();
 }
 
 fluke::Agent* 
@@ -58,6 +98,7 @@ fluke::ModuleAgent::copy( const Agent &ag ) {
     size_parent_ = ma->size_parent_;
     genome_ = ma->genome_->clone();
     inventorised_ = false;
+    score_ = ma->score_;
     // and copy the counts of genes
     std::copy( ma->ess_tags_now_.begin(), ma->ess_tags_now_.end(),
         std::back_inserter( ess_tags_now_ ) );
@@ -75,6 +116,7 @@ fluke::ModuleAgent::initialise() {
     genome_->nrRetroposons();
     // and that the length is cached
     genome_->fullSize();
+    score_ = fitness();
 }
 
 void 
@@ -88,6 +130,10 @@ fluke::ModuleAgent::step( Population &pop ) {
     }
 }
 
+double
+fluke::ModuleAgent::mortality() const
+{ return death_rate_; }
+
 fluke::Agent*
 fluke::ModuleAgent::sibling() {
     Agent *result = 0;
@@ -95,18 +141,19 @@ fluke::ModuleAgent::sibling() {
     distance_parent_ = distance_;
     size_parent_ = genome_->fullSize();
     // first perform sort-of mitosis
-    genome_->duplicate();
-    genome_->mutate();
+    Genome *sister_genome = genome_->replicate();
     inventorised_ = false;
-    Genome *sister_genome = genome_->split();
-    // build sister agent
-    ModuleAgent *sister = new ModuleAgent( type_, sister_genome );
-    std::copy( ess_tags_now_.begin(), ess_tags_now_.end(),
-        std::back_inserter( sister->ess_tags_now_ ) );
-    for( module_iter ii = mod_tags_now_.begin(); 
-        ii != mod_tags_now_.end(); ++ii ) {
-        sister->mod_tags_now_.push_back( 
-            std::vector< uint >( ii->begin(), ii->end() ) );
+    score_ = fitness();
+    // build sister agent from a dead one, such that the gene counts are
+    // copied into memory of before
+    ModuleAgent *sister = 
+        ObjectCache< ModuleAgent >::instance()->borrowObject();
+    sister->reborn( type_, sister_genome );
+    sister->ess_tags_now_.assign( ess_tags_now_.begin(), ess_tags_now_.end() );
+    sister->mod_tags_now_.resize( mod_tags_now_.size() );
+    for( uint i = 0; i != mod_tags_now_.size(); ++i ) {
+        sister->mod_tags_now_[ i ].assign( mod_tags_now_[ i ].begin(),
+            mod_tags_now_[ i ].end() );
     }
     // update parent info
     sister->distance_parent_ = distance_parent_;
@@ -118,6 +165,16 @@ fluke::ModuleAgent::sibling() {
 
 double
 fluke::ModuleAgent::score() const {
+#ifdef DEBUG
+    // fitness() fills caches of the genome, so tile threads reading the
+    // score of a neighbour must not call it
+    if( !uniform.parallel() ) assert( score_ == fitness() );
+#endif
+    return score_;
+}
+
+double
+fluke::ModuleAgent::fitness() const {
     // number of genes still to be copied is already in distance_
     double result = static_cast< double >( distance_ );
     // now see if we have any penalties to add
@@ -147,6 +204,7 @@ fluke::ModuleAgent::evaluate( const Environment &env ) {
         countGenes();
     }
     distance_ = essentialsScore( env ) + modulesScore( env );
+    score_ = fitness();
 }
 
 double
@@ -156,27 +214,48 @@ fluke::ModuleAgent::penalty( double ss ) const {
 
 void
 fluke::ModuleAgent::countGenes() {
-    // inventorise for essential genes and all modules
-    countEssentialGenes();
-    countModuleGenes();
+    // inventorise for essential genes and all modules, sharing the counts
+    ScratchScope scope;
+    Chromosome::gene_scratch aux;
+    genome_->geneCounts( aux );
+    countEssentialGenes( aux );
+    countModuleGenes( aux );
     inventorised_ = true;
 }
 
 void
 fluke::ModuleAgent::countEssentialGenes() {
-    // get the essential genes
-    Chromosome::tag_container aux = genome_->essentialTags();
-    std::sort( aux.begin(), aux.end() );
+    ScratchScope scope;
+    Chromosome::gene_scratch aux;
+    genome_->geneCounts( aux );
+    countEssentialGenes( aux );
+}
+
+void
+fluke::ModuleAgent::countModuleGenes() {
+    ScratchScope scope;
+    Chromosome::gene_scratch aux;
+    genome_->geneCounts( aux );
+    countModuleGenes( aux );
+}
+
+void
+fluke::ModuleAgent::countEssentialGenes( 
+    const Chromosome::gene_scratch &aux ) {
+    // the ordinary genes (module -1) come first
+    Chromosome::gene_scratch::const_iterator last = std::lower_bound( 
+        aux.begin(), aux.end(), 
+        std::make_pair( Chromosome::gene_key( 0, 0 ), 0u ) );
     // loop through two sorted vectors
     ess_tags_now_.clear();
     std::fill_n( std::back_inserter( ess_tags_now_ ), 
         essential_tags_.size(), 0 );
     uint i = 0;
-    Chromosome::tag_container::iterator j = aux.begin();
+    Chromosome::gene_scratch::const_iterator j = aux.begin();
     while( i != essential_tags_.size() ) {
-        if( j != aux.end() ) {
-            if( *j == essential_tags_[ i ] ) {
-                ++ess_tags_now_[ i ];
+        if( j != last ) {
+            if( j->first.second == essential_tags_[ i ] ) {
+                ess_tags_now_[ i ] += j->second;
                 ++j;
             } else {
                 ++i;
@@ -188,26 +267,31 @@ fluke::ModuleAgent::countEssentialGenes() {
 }
 
 void
-fluke::ModuleAgent::countModuleGenes() {
+fluke::ModuleAgent::countModuleGenes( 
+    const Chromosome::gene_scratch &aux ) {
     int jj = 0;
     module_iter ii = module_tags_.begin();
     if( mod_tags_now_.empty() ) {
         std::fill_n( std::back_inserter( mod_tags_now_ ), 
             module_tags_.size(), Chromosome::tag_container() );
     }
+    // the copy numbers are sorted on module first
+    Chromosome::gene_scratch::const_iterator first, last;
     while( ii != module_tags_.end() ) {
         // see which genes we have
-        Chromosome::tag_container aux = genome_->moduleTags( jj );
-        std::sort( aux.begin(), aux.end() );
+        first = std::lower_bound( aux.begin(), aux.end(), 
+            std::make_pair( Chromosome::gene_key( jj, 0 ), 0u ) );
+        last = std::lower_bound( first, aux.end(), 
+            std::make_pair( Chromosome::gene_key( jj + 1, 0 ), 0u ) );
         // Loop through tags
         mod_tags_now_[ jj ].clear();
         std::fill_n( std::back_inserter( mod_tags_now_[ jj ] ), ii->size(), 0 );
         uint i = 0;
-        Chromosome::tag_container::iterator j = aux.begin();
+        Chromosome::gene_scratch::const_iterator j = first;
         while( i != ii->size() ) {
-            if( j != aux.end() ) {
-                if( *j == ( *ii )[ i ] ) {
-                    ++mod_tags_now_[ jj ][ i ];
+            if( j != last ) {
+                if( j->first.second == ( *ii )[ i ] ) {
+                    mod_tags_now_[ jj ][ i ] += j->second;
                     ++j;
                 } else {
                     ++i;
@@ -267,15 +351,26 @@ fluke::ModuleAgent::modulesScore( const Environment &env ) {
     return result;
 }
 
+std::size_t
+fluke::ModuleAgent::bytes() const {
+    std::size_t result = sizeof( ModuleAgent ) + heap_bytes( mod_tags_now_ ) + 
+        heap_bytes( ess_tags_now_ );
+    for( uint i = 0; i != mod_tags_now_.size(); ++i ) {
+        result += heap_bytes( mod_tags_now_[ i ] );
+    }
+    return result;
+}
+
 void 
 fluke::ModuleAgent::write( std::ostream &os ) const {
-    os << "<agent type=\"" << type_ << "\" birth=\"" << me_.time;
-    os << "\" x=\"" << me_.x << "\" y=\"" << me_.y << "\" i=\"" << me_.i;
+    AgentTag me = myTag(), ancestor = parentTag();
+    os << "<agent type=\"" << type_ << "\" birth=\"" << me.time;
+    os << "\" x=\"" << me.x << "\" y=\"" << me.y << "\" i=\"" << me.i;
     os << "\">\n<class>ModuleAgent</class>\n";
     os << "<score>" << score() << "</score>\n";
-    os << "<parent time=\"" << ancestor_.time 
-       << "\" x=\"" << ancestor_.x << "\" y=\"" << ancestor_.y
-       << "\" i=\"" << ancestor_.i << "\"/>\n";
+    os << "<parent time=\"" << ancestor.time 
+       << "\" x=\"" << ancestor.x << "\" y=\"" << ancestor.y
+       << "\" i=\"" << ancestor.i << "\"/>\n";
     os << *genome_; 
     os << "<mods>";
     for( const_module_iter i = mod_tags_now_.begin(); 
@@ -33,6 +33,14 @@ fluke::ModuleDownstream::toPool() {
     ObjectCache< ModuleDownstream >::instance()->returnObject( this );
 }
 
+void*
+fluke::ModuleDownstream::operator new( std::size_t n ) 
+{ return ObjectCache< ModuleDownstream >::instance()->allocate( n ); }
+
+void
+fluke::ModuleDownstream::operator delete( void *p, std::size_t n ) 
+{ ObjectCache< ModuleDownstream >::instance()->deallocate( p, n ); }
+
 int 
 fluke::ModuleDownstream::mutate() {
     return 0;
@@ -28,7 +28,8 @@ fluke::ObserverManager::subscribe( Subject *s, LogObserver *lo ) {
 }
 
 void 
-fluke::ObserverManager::subscribe( Subject *s, AsyncLogObserver *lo ) {
+fluke::ObserverManager::subscribe( ObservedSubject *s, 
+    AsyncLogObserver *lo ) {
     s->attach( lo );
     subasynobs_.insert( std::make_pair( s, lo ) );
 }
@@ -25,6 +25,14 @@ fluke::OrdinaryDownstream::toPool() {
     ObjectCache< OrdinaryDownstream >::instance()->returnObject( this );
 }
 
+void*
+fluke::OrdinaryDownstream::operator new( std::size_t n ) 
+{ return ObjectCache< OrdinaryDownstream >::instance()->allocate( n ); }
+
+void
+fluke::OrdinaryDownstream::operator delete( void *p, std::size_t n ) 
+{ ObjectCache< OrdinaryDownstream >::instance()->deallocate( p, n ); }
+
 std::string 
 fluke::OrdinaryDownstream::asXmlString() const {
     return "<dstream id=\"" + boost::lexical_cast< std::string >( tag_ ) + 
@@ -14,13 +14,20 @@ bool fluke::Population::shuffle_ = false;
 double fluke::Population::threshold_ = 0.0;
 int fluke::Population::nr_agent_types_ = 0;
 std::string fluke::Population::placement_ = "random";
+std::string fluke::Population::update_scheme_ = "synchronous";
+int fluke::Population::threads_ = 1;
+int fluke::Population::tile_size_ = 32;
 
 fluke::Population::Population() 
     : plane_one_(), plane_two_(), 
       write_grid_( &plane_one_ ), read_grid_( &plane_two_ ),
-      write_agents_(), read_agents_(), agent_view_size_( 3 ) {
+      agents_one_( 0 ), agents_two_( 1 ),
+      write_agents_( &agents_one_ ), read_agents_( &agents_two_ ),
+      agent_view_size_( 3 ) {
     scaling_ = new NoScaling();
     selection_ = new RandSelection();
+    chooseKernel();
+    frontier_stale_ = true;
     async_agent_obs_ = 0;
     async_env_change_ = 0;
     async_dsbs_ = 0;
@@ -28,13 +35,15 @@ fluke::Population::Population()
 
 fluke::Population::Population( int x, int y, std::vector< Agent* > &vag, 
         ScalingScheme *sca, SelectionScheme *sel ) 
-    : plane_one_( boost::extents[ x ][ y ] ), 
-      plane_two_( boost::extents[ x ][ y ] ),
+    : plane_one_( x, y ), plane_two_( x, y ),
       write_grid_( &plane_one_ ), read_grid_( &plane_two_ ),
-      write_agents_(), read_agents_(),  
+      agents_one_( 0 ), agents_two_( 1 ),
+      write_agents_( &agents_one_ ), read_agents_( &agents_two_ ),
       scaling_( sca ), selection_( sel ), agent_view_size_( 3 ) {
-    // pre: x * y > |vag|
+    // pre: x * y > |vag|, x and y at least 3
     locations( shuffle_locs_ );
+    wrapTables();
+    chooseKernel();
     zero( reading );
     zero( writing );
     insert( vag );
@@ -46,13 +55,15 @@ fluke::Population::Population( int x, int y, std::vector< Agent* > &vag,
 fluke::Population::Population( int x, int y, std::vector< Agent* > &vag, 
     const std::vector< Location > &loc, 
     ScalingScheme *sca, SelectionScheme *sel ) 
-    : plane_one_( boost::extents[ x ][ y ] ),
-      plane_two_( boost::extents[ x ][ y ] ),
+    : plane_one_( x, y ), plane_two_( x, y ),
       write_grid_( &plane_one_ ), read_grid_( &plane_two_ ),
-      write_agents_(), read_agents_(),
+      agents_one_( 0 ), agents_two_( 1 ),
+      write_agents_( &agents_one_ ), read_agents_( &agents_two_ ),
       scaling_( sca ), selection_( sel ), agent_view_size_( 3 ) {
-    // pre: x * y > |vag|
+    // pre: x * y > |vag|, x and y at least 3
     locations( shuffle_locs_ );
+    wrapTables();
+    chooseKernel();
     zero( reading );
     zero( writing );
     insertAt( vag, loc );
@@ -62,19 +73,18 @@ fluke::Population::Population( int x, int y, std::vector< Agent* > &vag,
 }
 
 fluke::Population::Population( const Population &pop ) 
-    : plane_one_( 
-        boost::extents[ pop.write_grid_->shape()[ 0 ] ][ pop.write_grid_->shape()[ 1 ] ] ),
-      plane_two_( 
-        boost::extents[ pop.write_grid_->shape()[ 0 ] ][ pop.write_grid_->shape()[ 1 ] ] ),
+    : plane_one_( pop.write_grid_->shape()[ 0 ], pop.write_grid_->shape()[ 1 ] ),
+      plane_two_( pop.write_grid_->shape()[ 0 ], pop.write_grid_->shape()[ 1 ] ),
       write_grid_( &plane_one_ ), read_grid_( &plane_two_ ),
-      write_agents_(), read_agents_(), scaling_( 0 ), 
-      selection_( 0 ), agent_view_size_( 3 ) {
+      agents_one_( 0 ), agents_two_( 1 ),
+      write_agents_( &agents_one_ ), read_agents_( &agents_two_ ),
+      scaling_( 0 ), selection_( 0 ), agent_view_size_( 3 ) {
     // copy deep, all the way down!!
     zero( reading );
     zero( writing );
     // copy agents in map and grid
-    for( const_map_ag_iter i = pop.write_agents_.begin(); 
-        i != pop.write_agents_.end(); ++i ) {
+    for( const_map_ag_iter i = pop.write_agents_->begin(); 
+        i != pop.write_agents_->end(); ++i ) {
         // some cloning
         Agent *aux = i->first->clone();
         insertAt( aux, i->second );
@@ -88,6 +98,8 @@ fluke::Population::Population( const Population &pop )
     // last but not least...
     scaling_ = pop.scaling_->clone();
     selection_ = pop.selection_->clone();
+    wrapTables();
+    chooseKernel();
     model_ = pop.model_;
     async_dsbs_ = 0;
     async_agent_obs_ = 0;
@@ -95,19 +107,16 @@ fluke::Population::Population( const Population &pop )
 }
 
 fluke::Population::~Population() {
-    // how to deal with the shadow_agents_??
-    agents_map aux, bux;
-    std::set_intersection( write_agents_.begin(), write_agents_.end(), 
-        read_agents_.begin(), read_agents_.end(), 
-        std::inserter( aux, aux.begin() ) );
-    std::set_symmetric_difference( write_agents_.begin(), write_agents_.end(), 
-        read_agents_.begin(), read_agents_.end(), 
-        std::inserter( bux, bux.begin() ) );
-    // first explicitly delete the agents
-    for( const_map_ag_iter i = aux.begin(); i != aux.end(); ++i ) {
-        delete i->first;
+    // agents only in the read plane (they died last step) and then the 
+    // ones in the write plane
+    for( const_map_ag_iter i = read_agents_->begin(); 
+        i != read_agents_->end(); ++i ) {
+        if( !write_agents_->contains( i->first ) ) {
+            delete i->first;
+        }
     }
-    for( const_map_ag_iter i = bux.begin(); i != bux.end(); ++i ) {
+    for( const_map_ag_iter i = write_agents_->begin(); 
+        i != write_agents_->end(); ++i ) {
         delete i->first;
     }
     // and the rest    
@@ -126,31 +135,25 @@ fluke::Population::~Population() {
 
 std::vector< fluke::Agent* >
 fluke::Population::moore( const Location &loc ) {
-    // torus border
-    int n = read_grid_->shape()[ 0 ];
-    int m = read_grid_->shape()[ 1 ];
-    // do somethin smart...
+    // torus border is in the wrapping tables
     std::vector< Agent* > result;
-    int i = (loc.x - 1 + n) % n;
-    while( i != (loc.x + 2) % n ) {
-        int j = (loc.y - 1 + m) % m;
-        while( j != (loc.y + 2) % m ) {
-            result.push_back( ( *read_grid_ )[ i ][ j ] );
-            j = (j + 1) % m;
+    for( int i = 0; i < agent_view_size_; ++i ) {
+        for( int j = 0; j < agent_view_size_; ++j ) {
+            result.push_back( ( *read_grid_ )
+                [ wrap_x_[ loc.x + i ] ][ wrap_y_[ loc.y + j ] ] );
         }
-        i = (i + 1) % n;
     }
     return result;
 }
 
 std::vector< fluke::Agent* >
 fluke::Population::moore( const Agent &ag ) {
-    return moore( read_agents_[ const_cast< Agent* >( &ag ) ] );
+    return moore( read_agents_->where( &ag ) );
 }
 
 fluke::Location
 fluke::Population::whereIs( const Agent &ag ) {
-    return read_agents_[ const_cast< Agent* >( &ag ) ];
+    return read_agents_->where( &ag );
 }
 
 void
@@ -159,8 +162,8 @@ fluke::Population::initialise() {
 #ifdef DEBUG
     cout << "! init population" << endl;
 #endif
-    for( map_ag_iter i = write_agents_.begin(); 
-        i != write_agents_.end(); ++i ) {
+    for( map_ag_iter i = write_agents_->begin(); 
+        i != write_agents_->end(); ++i ) {
         AgentTag aux = AgentTag( model_->now(), i->second.x, i->second.y, 0 );
         i->first->myTag( aux );
     }
@@ -182,14 +185,30 @@ fluke::Population::evaluate( const Environment &env ) {
         async_env_change_->update( this );
     }
     // end hack!
-    for( map_ag_iter i = write_agents_.begin(); 
-        i != write_agents_.end(); ++i ) {
+    for( map_ag_iter i = write_agents_->begin(); 
+        i != write_agents_->end(); ++i ) {
         i->first->evaluate( env );
     }
 }
 
 void 
 fluke::Population::step() {
+    // scratch used outside a scope is gone by now, rewind the arenas
+    ScratchArena::resetAll();
+    if( update_scheme_ == "tiled" ) {
+        tiledStep();
+    } else if( update_scheme_ == "event" ) {
+        eventStep();
+    } else {
+        synchronousStep();
+    }
+    // keep everything consistent
+    swap();
+    if( shuffle_ ) shuffle();    
+}
+
+void
+fluke::Population::synchronousStep() {
     // deterministic synchronous stepping
     // visit every site
     for( uint i = 0; i < read_grid_->shape()[ 0 ]; ++i ) {
@@ -202,77 +221,439 @@ fluke::Population::step() {
                 }
             } else {
                 // empty spot
-                // get nbh
-                Location nux;
-                nux.x = i;
-                nux.y = j;
-                std::vector< Agent* > aux( moore( nux ) );
-                // remove non-agents
-                aux.erase( std::remove_if( aux.begin(), aux.end(), 
-                        IsNotAvailable() ), aux.end() );
-                if( aux.size() > 0 ) {
-                    // scores of agents in nbh
-                    std::vector< double > cux;
-                    for( ag_iter k = aux.begin(); k < aux.end(); ++k ) {
-                        cux.push_back( ( **k ).score() );
-                    }
-                    // scale the scores
-                    scaling_->scale( cux );
-                    // check for sum of fitness
-                    double bux = threshold_ -
-                        std::accumulate( cux.begin(), cux.end(), 0.0 );
-                    if( bux > 0.0 ) {
-                        aux.push_back( 0 );
-                        cux.push_back( bux );
-                    }
-                    // select an agent (or a null pointer)
-                    Agent *eux = selection_->select( aux, cux );
-                    if( eux != 0 ) {
-                        // log this agent be4 mutations
-                        if( async_agent_obs_ != 0 ) {
-                            async_agent_obs_->update( eux );
-                        }
-                        // spawn a sibling
-                        Agent *fux = eux->sibling();
-                        // get the mother tag and set ancestor tags of children
-                        AgentTag gux = eux->myTag();
-                        eux->parentTag( gux );
-                        fux->parentTag( gux );
-                        // update children's tag
-                        if( gux.time == model_->now() ) {
-                            // increase index, agent is part of a 'cascade'
-                            ++gux.i;
-                        }
-                        gux.time = model_->now();
-                        eux->myTag( gux );
-                        fux->myTag( AgentTag( model_->now(), i, j, 0 ) );
-                        // evaluate both in the environment
-                        eux->evaluate( model_->environment() );
-                        fux->evaluate( model_->environment() );
-                        // and insert it in the grid
-                        insertAt( fux, nux );
-                        // log after mutations what happened (dsbs)
-                        if( async_dsbs_ != 0 ) {
-                            DuoAgent hux( eux, fux );
-                            async_dsbs_->update( &hux );
-                        }
-                    }
+                Location nux( i, j );
+                Agent *eux = select( nux );
+                if( eux != 0 ) {
+                    insertAt( reproduce( eux, nux ), nux );
                 }
             }
         }
     }
+}
+
+void
+fluke::Population::tiledStep() {
+    // Domain decomposition: the torus is cut in tiles of tile_size_ squared
+    // and every tile draws from a random stream of its own, seeded from the
+    // global stream in tile order. Deaths and parent selection only read
+    // the read plane (the halo of a tile is simply its neighbours' cells).
+    // Births are done by the tile the parent lives in, such that no two 
+    // threads touch the same genome. Hence, the outcome depends on the tile
+    // size, but not on the number of threads. With a tile size that is a 
+    // multiple of the block edge of the grid (8), every tile covers whole
+    // storage blocks and threads do not share cache lines.
+    //
+    // The birth phase (reproduce, sibling, mutation) runs in parallel. It
+    // is safe as long as the following holds.
+    // - An agent, its genome and its chromosomes are only touched by the
+    //   thread of the tile of the agent, mutable caches included. Others
+    //   only read scores, which are filled before (see ModuleAgent).
+    // - Chromosome buffers shared copy on write are only read while 
+    //   shared. A chromosome writes its buffer only as the sole owner 
+    //   (Chromosome::own). Other chromosomes get hold of a buffer by 
+    //   copying from its owner, on the owner's thread, or from the intern
+    //   table, which keeps a reference of its own. Hence a unique buffer
+    //   stays unique, and reference counts are atomic.
+    // - The intern table is guarded by a mutex. Pools are created once 
+    //   and cache per thread, scratch arenas and random streams are per
+    //   thread.
+    // - The environment, the read plane and the reference tags of 
+    //   ModuleAgent are read only.
+    // - Asynchronous observers are not thread safe, with them the births
+    //   run on one thread.
+    int n = read_grid_->shape()[ 0 ];
+    int m = read_grid_->shape()[ 1 ];
+    nr_tiles_x_ = ( n + tile_size_ - 1 ) / tile_size_;
+    nr_tiles_y_ = ( m + tile_size_ - 1 ) / tile_size_;
+    int nt = nr_tiles_x_ * nr_tiles_y_;
+    if( static_cast< int >( tile_streams_.size() ) != nt ) {
+        tile_streams_.assign( nt, uniform_gen_type( generator ) );
+        tile_deaths_.resize( nt );
+        tile_births_.resize( nt );
+        tile_owned_.resize( nt );
+    }
+    for( int t = 0; t < nt; ++t ) {
+        tile_streams_[ t ].base().seed( static_cast< boost::uint32_t >( 
+            rand_range< double >( std::numeric_limits< boost::uint32_t >::max() ) ) );
+        tile_deaths_[ t ].clear();
+        tile_births_[ t ].clear();
+        tile_owned_[ t ].clear();
+    }
     
-    // keep everything consistent
-    swap();
-    if( shuffle_ ) shuffle();    
+    // deaths and parent selection
+    runTiles( deciding, threads_ );
+    // hand the births to the tile of the parent, in tile order
+    for( int t = 0; t < nt; ++t ) {
+        for( birth_iter i = tile_births_[ t ].begin(); 
+            i != tile_births_[ t ].end(); ++i ) {
+            Location aux = read_agents_->where( i->parent );
+            tile_owned_[ tileOf( aux ) ].push_back( *i );
+        }
+    }
+    // births; the asynchronous observers log in order, so use one thread
+    if( async_agent_obs_ == 0 && async_dsbs_ == 0 ) {
+        runTiles( birthing, threads_ );
+    } else {
+        runTiles( birthing, 1 );
+    }
+    
+    // and write the results into the write plane
+    for( int t = 0; t < nt; ++t ) {
+        for( loc_iter i = tile_deaths_[ t ].begin(); 
+            i != tile_deaths_[ t ].end(); ++i ) {
+            shallowEraseAt( *i );
+        }
+    }
+    for( int t = 0; t < nt; ++t ) {
+        for( birth_iter i = tile_owned_[ t ].begin(); 
+            i != tile_owned_[ t ].end(); ++i ) {
+            insertAt( i->child, i->where );
+        }
+    }
+}
+
+void
+fluke::Population::runTiles( tile_phase p, int nr_threads ) {
+    next_tile_ = 0;
+    uniform.parallel( true );
+    if( nr_threads > 1 ) {
+        boost::thread_group aux;
+        for( int i = 0; i < nr_threads; ++i ) {
+            aux.create_thread( boost::bind( &Population::tileWorker, this, p ) );
+        }
+        aux.join_all();
+    } else {
+        tileWorker( p );
+    }
+    uniform.parallel( false );
+}
+
+void
+fluke::Population::tileWorker( tile_phase p ) {
+    int nt = nr_tiles_x_ * nr_tiles_y_;
+    int t = 0;
+    while( t < nt ) {
+        {
+            boost::mutex::scoped_lock lock( tile_mutex_ );
+            t = next_tile_++;
+        }
+        if( t < nt ) {
+            uniform.bind( &tile_streams_[ t ] );
+            if( p == deciding ) {
+                decideTile( t );
+            } else {
+                birthTile( t );
+            }
+        }
+    }
+    uniform.bind( 0 );
+}
+
+void
+fluke::Population::decideTile( int t ) {
+    int n = read_grid_->shape()[ 0 ];
+    int m = read_grid_->shape()[ 1 ];
+    int x0 = ( t / nr_tiles_y_ ) * tile_size_;
+    int y0 = ( t % nr_tiles_y_ ) * tile_size_;
+    for( int i = x0; i < std::min( x0 + tile_size_, n ); ++i ) {
+        for( int j = y0; j < std::min( y0 + tile_size_, m ); ++j ) {
+            Agent *aux = ( *read_grid_ )[ i ][ j ];
+            if( aux != 0 ) {
+                // occupied spot
+                aux->step( *this );
+                if( aux->dying() ) {
+                    tile_deaths_[ t ].push_back( Location( i, j ) );
+                }
+            } else {
+                // empty spot
+                Birth bux;
+                bux.where = Location( i, j );
+                bux.parent = select( bux.where );
+                bux.child = 0;
+                if( bux.parent != 0 ) {
+                    tile_births_[ t ].push_back( bux );
+                }
+            }
+        }
+    }
+}
+
+void
+fluke::Population::birthTile( int t ) {
+    for( birth_iter i = tile_owned_[ t ].begin(); 
+        i != tile_owned_[ t ].end(); ++i ) {
+        i->child = reproduce( i->parent, i->where );
+    }
+}
+
+int
+fluke::Population::tileOf( const Location &loc ) const {
+    return ( loc.x / tile_size_ ) * nr_tiles_y_ + loc.y / tile_size_;
+}
+
+void
+fluke::Population::eventStep() {
+    // Asynchronous updating with Gillespie's direct method. Every agent
+    // dies at its mortality and every empty cell with neighbours tries to
+    // get a newborn at rate one, per unit of time. Changes are effective
+    // immediately on both planes. The frontier of empty cells is kept up 
+    // to date, so a unit of time costs about as many events as there are
+    // deaths plus frontier cells, independent of the area. A birth attempt
+    // may still fail (sum of fitness below the threshold). Agent::step is
+    // not called, deaths are its only effect.
+    //
+    // Agents are picked uniformly at the highest mortality and thinned to
+    // their own, with a single agent type nothing is thinned.
+    if( frontier_stale_ ) {
+        rebuildFrontier();
+    }
+    double now = -log( 1.0 - uniform() ) / 
+        ( read_agents_->size() * max_mortality_ + frontier_.size() );
+    while( now < 1.0 ) {
+        uint na = read_agents_->size();
+        uint nf = frontier_.size();
+        double dd = na * max_mortality_;
+        double r = uniform() * ( dd + nf );
+        if( r < dd ) {
+            // death, unless thinned
+            map_ag_iter aux = read_agents_->begin() + 
+                std::min( static_cast< uint >( r / max_mortality_ ), na - 1 );
+            double m = aux->first->mortality();
+            if( m >= max_mortality_ || uniform() * max_mortality_ < m ) {
+                removeNow( aux->second );
+            }
+        } else {
+            // reproduction into an empty cell
+            int bux = frontier_[ std::min( static_cast< uint >( r - dd ), 
+                nf - 1 ) ];
+            Location nux( read_grid_->row( bux ), read_grid_->column( bux ) );
+            Agent *eux = select( nux );
+            if( eux != 0 ) {
+                placeNow( reproduce( eux, nux ), nux );
+            }
+        }
+        // the next event
+        now += -log( 1.0 - uniform() ) / 
+            ( read_agents_->size() * max_mortality_ + frontier_.size() );
+    }
+}
+
+void
+fluke::Population::placeNow( Agent *ag, const Location &loc ) {
+    ( *read_grid_ )[ loc.x ][ loc.y ] = ag;
+    ( *read_agents_ )[ ag ] = loc;
+    ( *write_grid_ )[ loc.x ][ loc.y ] = ag;
+    ( *write_agents_ )[ ag ] = loc;
+    max_mortality_ = std::max( max_mortality_, ag->mortality() );
+    crowd( loc, 1 );
+    refreshFrontier( loc );
+}
+
+void
+fluke::Population::removeNow( Location loc ) {
+    Agent *ag = ( *read_grid_ )[ loc.x ][ loc.y ];
+    read_agents_->erase( ag );
+    write_agents_->erase( ag );
+    ( *read_grid_ )[ loc.x ][ loc.y ] = 0;
+    ( *write_grid_ )[ loc.x ][ loc.y ] = 0;
+    ag->toPool();
+    crowd( loc, -1 );
+    refreshFrontier( loc );
+}
+
+void
+fluke::Population::rebuildFrontier() {
+    // visit the cells row by row, the order of the frontier is that of 
+    // the grid and not of its storage
+    frontier_.clear();
+    frontier_pos_.assign( read_grid_->capacity(), -1 );
+    for( uint i = 0; i < read_grid_->shape()[ 0 ]; ++i ) {
+        for( uint j = 0; j < read_grid_->shape()[ 1 ]; ++j ) {
+            int aux = read_grid_->index( i, j );
+            if( read_grid_->at( aux ) == 0 && nbh_count_[ aux ] > 0 ) {
+                frontier_pos_[ aux ] = frontier_.size();
+                frontier_.push_back( aux );
+            }
+        }
+    }
+    max_mortality_ = 0.0;
+    for( map_ag_iter i = read_agents_->begin(); i != read_agents_->end(); 
+        ++i ) {
+        max_mortality_ = std::max( max_mortality_, i->first->mortality() );
+    }
+    frontier_stale_ = false;
+}
+
+void
+fluke::Population::refreshFrontier( const Location &loc ) {
+    const agents_grid &g = *read_grid_;
+    for( int i = 0; i < agent_view_size_; ++i ) {
+        for( int j = 0; j < agent_view_size_; ++j ) {
+            int aux = g.index( wrap_x_[ loc.x + i ], wrap_y_[ loc.y + j ] );
+            bool bux = g.at( aux ) == 0 && nbh_count_[ aux ] > 0;
+            if( bux && frontier_pos_[ aux ] < 0 ) {
+                frontier_pos_[ aux ] = frontier_.size();
+                frontier_.push_back( aux );
+            } else if( !bux && frontier_pos_[ aux ] >= 0 ) {
+                // move the last one into the hole
+                int cux = frontier_pos_[ aux ];
+                frontier_[ cux ] = frontier_.back();
+                frontier_pos_[ frontier_.back() ] = cux;
+                frontier_.pop_back();
+                frontier_pos_[ aux ] = -1;
+            }
+        }
+    }
+}
+
+fluke::Agent*
+fluke::Population::select( const Location &nux ) {
+    // no neighbours, no reproduction (and no random number drawn)
+    if( nbh_count_[ read_grid_->index( nux.x, nux.y ) ] == 0 ) {
+        return 0;
+    }
+    return ( this->*kernel_ )( nux );
+}
+
+template< class Sc, class Se > fluke::Agent*
+fluke::Population::selectWith( const Location &nux ) {
+    // Moore neighbourhood, scaling, threshold and roulette in one go on the
+    // stack. The scheme types are known, so apply() and pick() are inlined.
+    Agent *aux[ 10 ];
+    double cux[ 10 ];
+    int k = 0;
+    const agents_grid &g = *read_grid_;
+    for( int i = 0; i < 3; ++i ) {
+        int x = wrap_x_[ nux.x + i ];
+        for( int j = 0; j < 3; ++j ) {
+            Agent *bux = g.at( g.index( x, wrap_y_[ nux.y + j ] ) );
+            if( bux != 0 ) {
+                aux[ k ] = bux;
+                cux[ k ] = bux->score();
+                ++k;
+            }
+        }
+    }
+#ifdef DEBUG
+    assert( k == nbh_count_[ g.index( nux.x, nux.y ) ] );
+#endif
+    Agent *eux = 0;
+    if( k > 0 ) {
+        // scale the scores and sum them cumulatively
+        static_cast< Sc* >( scaling_ )->apply( cux, k );
+        for( int i = 1; i < k; ++i ) {
+            cux[ i ] += cux[ i - 1 ];
+        }
+        // check for sum of fitness
+        double bux = threshold_ - cux[ k - 1 ];
+        if( bux > 0.0 ) {
+            aux[ k ] = 0;
+            cux[ k ] = cux[ k - 1 ] + bux;
+            ++k;
+        }
+        // select an agent (or a null pointer)
+        eux = static_cast< Se* >( selection_ )->pick( aux, cux, k );
+    }
+    return eux;
+}
+
+void
+fluke::Population::chooseKernel() {
+    if( typeid( *scaling_ ) == typeid( LinearScaling ) ) {
+        chooseKernel< LinearScaling >();
+    } else if( typeid( *scaling_ ) == typeid( PowerScaling ) ) {
+        chooseKernel< PowerScaling >();
+    } else if( typeid( *scaling_ ) == typeid( NoScaling ) ) {
+        chooseKernel< NoScaling >();
+    } else {
+        chooseKernel< ScalingScheme >();
+    }
+}
+
+template< class Sc > void
+fluke::Population::chooseKernel() {
+    if( typeid( *selection_ ) == typeid( ProbalisticSelection ) ) {
+        kernel_ = &Population::selectWith< Sc, ProbalisticSelection >;
+    } else if( typeid( *selection_ ) == typeid( RandSelection ) ) {
+        kernel_ = &Population::selectWith< Sc, RandSelection >;
+    } else {
+        kernel_ = &Population::selectWith< Sc, SelectionScheme >;
+    }
+}
+
+void
+fluke::Population::wrapTables() {
+    int n = read_grid_->shape()[ 0 ];
+    int m = read_grid_->shape()[ 1 ];
+    wrap_x_.resize( n + 2 );
+    wrap_y_.resize( m + 2 );
+    for( int i = 0; i < n + 2; ++i ) {
+        wrap_x_[ i ] = ( i - 1 + n ) % n;
+    }
+    for( int j = 0; j < m + 2; ++j ) {
+        wrap_y_[ j ] = ( j - 1 + m ) % m;
+    }
+    nbh_count_.assign( read_grid_->capacity(), 0 );
+    frontier_stale_ = true;
+}
+
+void
+fluke::Population::crowd( const Location &loc, int d ) {
+    for( int i = 0; i < agent_view_size_; ++i ) {
+        int aux = wrap_x_[ loc.x + i ];
+        for( int j = 0; j < agent_view_size_; ++j ) {
+            nbh_count_[ read_grid_->index( aux, wrap_y_[ loc.y + j ] ) ] += d;
+        }
+    }
+}
+
+void
+fluke::Population::recount() {
+    std::fill( nbh_count_.begin(), nbh_count_.end(), 0 );
+    for( const_map_ag_iter i = read_agents_->begin(); 
+        i != read_agents_->end(); ++i ) {
+        crowd( i->second, 1 );
+    }
+    frontier_stale_ = true;
+}
+
+fluke::Agent*
+fluke::Population::reproduce( Agent *eux, const Location &nux ) {
+    // log this agent be4 mutations
+    if( async_agent_obs_ != 0 ) {
+        async_agent_obs_->update( eux );
+    }
+    // spawn a sibling
+    Agent *fux = eux->sibling();
+    // get the mother tag and set ancestor tags of children
+    AgentTag gux = eux->myTag();
+    eux->parentTag( gux );
+    fux->parentTag( gux );
+    // update children's tag
+    if( gux.time == model_->now() ) {
+        // increase index, agent is part of a 'cascade'
+        ++gux.i;
+    }
+    gux.time = model_->now();
+    eux->myTag( gux );
+    fux->myTag( AgentTag( model_->now(), nux.x, nux.y, 0 ) );
+    // evaluate both in the environment
+    eux->evaluate( model_->environment() );
+    fux->evaluate( model_->environment() );
+    // log after mutations what happened (dsbs)
+    if( async_dsbs_ != 0 ) {
+        DuoAgent hux( eux, fux );
+        async_dsbs_->update( &hux );
+    }
+    return fux;
 }
 
 void
 fluke::Population::finish() {
     // log all agents to the ancestor tracing observer
     if( async_agent_obs_ != 0 ) {
-        for( map_ag_iter i = write_agents_.begin(); 
-            i != write_agents_.end(); ++i ) {
+        for( map_ag_iter i = write_agents_->begin(); 
+            i != write_agents_->end(); ++i ) {
             async_agent_obs_->update( i->first );
         }
     }
@@ -326,22 +707,23 @@ fluke::Population::insertAt(
 
 void
 fluke::Population::insertAt( Agent* ag, const Location &loc ) {
-    write_agents_[ ag ] = loc;
+    ( *write_agents_ )[ ag ] = loc;
     ( *write_grid_ )[ loc.x ][ loc.y ] = ag;
+    dirty_.push_back( loc );
 }
 
 void 
 fluke::Population::erase( std::vector< Agent* > &ag ) {
     std::vector< Location > result;
     for( ag_iter i = ag.begin(); i != ag.end(); ++i ) {
-        result.push_back( write_agents_[ *i ] );
+        result.push_back( write_agents_->where( *i ) );
     }
     eraseAt( result );
 }
 
 void
 fluke::Population::erase( Agent* ag ) {
-    eraseAt( write_agents_[ ag ] );
+    eraseAt( write_agents_->where( ag ) );
 }
 
 void 
@@ -353,20 +735,22 @@ fluke::Population::eraseAt( const std::vector< Location > &loc ) {
 
 void
 fluke::Population::eraseAt( Location loc ) {
-    write_agents_.erase( ( *write_grid_ )[ loc.x ][ loc.y ] );
-    delete ( *write_grid_ )[ loc.x ][ loc.y ];
+    write_agents_->erase( ( *write_grid_ )[ loc.x ][ loc.y ] );
+    ( *write_grid_ )[ loc.x ][ loc.y ]->toPool();
     ( *write_grid_ )[ loc.x ][ loc.y ] = 0;
+    dirty_.push_back( loc );
 }
 
 void
 fluke::Population::shallowErase( Agent* ag ) {
-    shallowEraseAt( write_agents_[ ag ] );
+    shallowEraseAt( write_agents_->where( ag ) );
 }
 
 void
 fluke::Population::shallowEraseAt( Location loc ) {
-    write_agents_.erase( ( *write_grid_ )[ loc.x ][ loc.y ] );
+    write_agents_->erase( ( *write_grid_ )[ loc.x ][ loc.y ] );
     ( *write_grid_ )[ loc.x ][ loc.y ] = 0;
+    dirty_.push_back( loc );
 }
 
 std::vector< fluke::Location >
@@ -455,43 +839,31 @@ void
 fluke::Population::swap() {
     // swap grids and mapping, shadow is readable now...
     std::swap( write_grid_, read_grid_ );
-    write_agents_.swap( read_agents_ );
+    std::swap( write_agents_, read_agents_ );
     
-    // keep data consistent
-    for( uint i = 0; i < read_grid_->shape()[ 0 ]; ++i ) {
-        for( uint j = 0; j < read_grid_->shape()[ 1 ]; ++j ) {
-            if( (* read_grid_ )[ i ][ j ] != 0 && 
-                ( *write_grid_ )[ i ][ j ] == 0 ) {
-                // insertion happened last time
-                Location nux( i, j );
-                insertAt( ( *read_grid_ )[ i ][ j ], nux ); 
-            } else if( (* read_grid_ )[ i ][ j ] == 0 &&
-                ( *write_grid_ )[ i ][ j ] != 0 ) {
-                // deletion happened last time
-                Location nux( i, j );
-                eraseAt( nux );
-            }
-        }
+    // keep data consistent, only visiting the cells that changed. The
+    // reconciliation itself dirties cells too, but those are consistent
+    // afterwards, hence forgotten. The neighbour counts follow the changes
+    // of the read plane.
+    uint n = dirty_.size();
+    if( n > 0 ) {
+        frontier_stale_ = true;
     }
-}
-
-void
-fluke::Population::swap( grid_type tt, const Location &a, const Location &b ) {
-    agents_grid *g = write_grid_;
-    agents_map *m = &write_agents_;
-    if( tt == reading ) {
-        g = read_grid_;
-        m = &read_agents_;
-    }
-    // first swap in map
-    if( ( *g )[ a.x ][ a.y ] != 0 ) {
-        ( *m )[ ( *g )[ a.x ][ a.y ] ] = b;
-    }
-    if( ( *g )[ b.x ][ b.y ] != 0 ) {
-        ( *m )[ ( *g )[ b.x ][ b.y ] ] = a;
+    for( uint k = 0; k < n; ++k ) {
+        Location nux( dirty_[ k ] );
+        if( ( *read_grid_ )[ nux.x ][ nux.y ] != 0 && 
+            ( *write_grid_ )[ nux.x ][ nux.y ] == 0 ) {
+            // insertion happened last time
+            insertAt( ( *read_grid_ )[ nux.x ][ nux.y ], nux ); 
+            crowd( nux, 1 );
+        } else if( ( *read_grid_ )[ nux.x ][ nux.y ] == 0 &&
+            ( *write_grid_ )[ nux.x ][ nux.y ] != 0 ) {
+            // deletion happened last time
+            eraseAt( nux );
+            crowd( nux, -1 );
+        }
     }
-    // now swap in grid
-    std::swap( ( *g )[ a.x ][ a.y ], ( *g )[ b.x ][ b.y ] );
+    dirty_.clear();
 }
 
 void
@@ -505,13 +877,35 @@ fluke::Population::shuffle() {
     }
     cout << endl;
 #endif
-    const_loc_iter aux = shuffle_locs_.begin();
-    for( uint i = 0; i < read_grid_->shape()[ 0 ]; ++i ) {
-        for( uint j = 0; j < read_grid_->shape()[ 1 ]; ++j ) {
-            Location bux( i, j );
-            swap( reading, *aux, bux );
-            swap( writing, *aux, bux );
-            ++aux;
+    // swap the k-th cell (row major) with the k-th shuffled location, 
+    // directly in the storage of both planes. The agent indices are updated
+    // afterwards in one pass, instead of for every swap.
+    uint m = read_grid_->shape()[ 1 ];
+    for( uint k = 0; k < shuffle_locs_.size(); ++k ) {
+        int aux = read_grid_->index( shuffle_locs_[ k ].x, 
+            shuffle_locs_[ k ].y );
+        int bux = read_grid_->index( k / m, k % m );
+        std::swap( read_grid_->at( aux ), read_grid_->at( bux ) );
+        std::swap( write_grid_->at( aux ), write_grid_->at( bux ) );
+    }
+    relocate( reading );
+    relocate( writing );
+    recount();
+}
+
+void
+fluke::Population::relocate( grid_type tt ) {
+    agents_grid *g = write_grid_;
+    agents_map *m = write_agents_;
+    if( tt == reading ) {
+        g = read_grid_;
+        m = read_agents_;
+    }
+    for( uint i = 0; i < g->shape()[ 0 ]; ++i ) {
+        for( uint j = 0; j < g->shape()[ 1 ]; ++j ) {
+            if( ( *g )[ i ][ j ] != 0 ) {
+                ( *m )[ ( *g )[ i ][ j ] ] = Location( i, j );
+            }
         }
     }
 }
@@ -576,11 +970,49 @@ bool
 fluke::Population::shuffling()
 { return shuffle_; }
 
+void
+fluke::Population::updateScheme( const std::string &s ) {
+    if( s != "synchronous" && s != "tiled" && s != "event" ) {
+        throw "Unknown update scheme.";
+    }
+    update_scheme_ = s;
+}
+
+std::string
+fluke::Population::updateScheme()
+{ return update_scheme_; }
+
+void
+fluke::Population::nrThreads( int n ) {
+    if( n < 1 ) {
+        throw "Need at least one thread.";
+    }
+    threads_ = n;
+}
+
+int
+fluke::Population::nrThreads()
+{ return threads_; }
+
+void
+fluke::Population::tileSize( int n ) {
+    if( n < 1 ) {
+        throw "Tile size should be positive.";
+    }
+    tile_size_ = n;
+}
+
+int
+fluke::Population::tileSize()
+{ return tile_size_; }
+
 bool
 fluke::Population::hasEveryAgentType() const {
-    std::vector< uint > aux( nr_agent_types_, 0 );
-    const_map_ag_iter i = write_agents_.begin();
-    const_map_ag_iter j = write_agents_.end();
+    // asked every timestep
+    ScratchScope scope;
+    scratch_vector< uint >::type aux( nr_agent_types_, 0 );
+    const_map_ag_iter i = write_agents_->begin();
+    const_map_ag_iter j = write_agents_->end();
 /*#ifdef DEBUG
     std::cout << "! has all agents\n";
 #endif*/
@@ -599,6 +1031,30 @@ fluke::Population::hasEveryAgentType() const {
     return std::accumulate( aux.begin(), aux.end(), 0 ) == nr_agent_types_;
 }
 
+std::size_t
+fluke::Population::gridBytes() const {
+    std::size_t result = plane_one_.bytes() + plane_two_.bytes();
+    result += heap_bytes( shuffle_locs_ ) + heap_bytes( wrap_x_ ) + 
+        heap_bytes( wrap_y_ ) + heap_bytes( nbh_count_ ) + 
+        heap_bytes( frontier_ ) + heap_bytes( frontier_pos_ ) + 
+        heap_bytes( dirty_ ) + heap_bytes( tile_streams_ );
+    for( uint i = 0; i != tile_deaths_.size(); ++i ) {
+        result += heap_bytes( tile_deaths_[ i ] );
+    }
+    for( uint i = 0; i != tile_births_.size(); ++i ) {
+        result += heap_bytes( tile_births_[ i ] );
+    }
+    for( uint i = 0; i != tile_owned_.size(); ++i ) {
+        result += heap_bytes( tile_owned_[ i ] );
+    }
+    return result;
+}
+
+std::size_t
+fluke::Population::indexBytes() const {
+    return agents_one_.bytes() + agents_two_.bytes();
+}
+
 void
 fluke::Population::write( std::ostream &os ) const {
     // write the 'shadow' plane
@@ -616,8 +1072,8 @@ fluke::Population::write( std::ostream &os ) const {
         os << "\n";
     }
     os << "Shadow/read map:\n";
-    for( const_map_ag_iter i = read_agents_.begin();
-        i != read_agents_.end(); ++i ) {
+    for( const_map_ag_iter i = read_agents_->begin();
+        i != read_agents_->end(); ++i ) {
             os << i->first << "\n";
     }
     // write the 'readable' plane
@@ -635,8 +1091,8 @@ fluke::Population::write( std::ostream &os ) const {
         os << "\n";
     }
     os << "Current/write map:\n";
-    for( const_map_ag_iter i = write_agents_.begin();
-        i != write_agents_.end(); ++i ) {
+    for( const_map_ag_iter i = write_agents_->begin();
+        i != write_agents_->end(); ++i ) {
             os << i->first << "\n";
     }
 
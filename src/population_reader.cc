@@ -227,6 +227,8 @@ fluke::PopulationReader::endElement( const XMLCh* const uri,
         chromo_->mutationRate( 
             factory_->conf_->optionAsDouble( "mut_rate", type_ ) );
         chromo_->mutationScheme( factory_->mutateRates( type_ ) );
+        chromo_->skipAhead( factory_->conf_->optionAsString( 
+            "mutate_sampling", type_ ) == "skip" );
     } else if( aux == "simulation" ) {
         done_ = true;
     }
@@ -10,7 +10,7 @@
 template<> fluke::ObjectCache< fluke::Repeat >* 
 fluke::ObjectCache< fluke::Repeat >::instance_ = 0;
 
-fluke::Repeat::Repeat() : ChromosomeElement(), dsb_( false ) {}
+fluke::Repeat::Repeat() : ChromosomeElement( REPEAT ), dsb_( false ) {}
 
 fluke::Repeat::Repeat( const Repeat &tp ) : ChromosomeElement( tp ) {
     Repeat::copy( tp );
@@ -35,6 +35,14 @@ fluke::Repeat::toPool() {
     ObjectCache< Repeat >::instance()->returnObject( this );
 }
 
+void*
+fluke::Repeat::operator new( std::size_t n ) 
+{ return ObjectCache< Repeat >::instance()->allocate( n ); }
+
+void
+fluke::Repeat::operator delete( void *p, std::size_t n ) 
+{ ObjectCache< Repeat >::instance()->deallocate( p, n ); }
+
 std::string 
 fluke::Repeat::asXmlString() const { 
     std::string aux( "<repeat dsb=" );
@@ -29,6 +29,14 @@ fluke::Retroposon::toPool() {
     ObjectCache< Retroposon >::instance()->returnObject( this );
 }
 
+void*
+fluke::Retroposon::operator new( std::size_t n ) 
+{ return ObjectCache< Retroposon >::instance()->allocate( n ); }
+
+void
+fluke::Retroposon::operator delete( void *p, std::size_t n ) 
+{ ObjectCache< Retroposon >::instance()->deallocate( p, n ); }
+
 std::string 
 fluke::Retroposon::asXmlString() const {
     return "<tposon id=\"" + boost::lexical_cast< std::string >( tag_ ) +
@@ -7,20 +7,11 @@
 #include "selection.hh"
 
 fluke::Agent* 
-fluke::RandSelection::select(
-        std::vector< Agent* > &va, std::vector< double > &sc ) {
-    // note: ignoring scores
-    return va[ static_cast< int >( rand_range( va.size() ) ) ];
+fluke::RandSelection::select( Agent **va, const double *sc, int n ) {
+    return pick( va, sc, n );
 }
 
 fluke::Agent* 
-fluke::ProbalisticSelection::select( 
-        std::vector< Agent* > &va, std::vector< double > &sc ) {
-    // note: the "no-selection" case may be a 0-pointer in 'va'
-    std::partial_sum( sc.begin(), sc.end(), sc.begin() );
-    std::vector< double >::iterator aux = 
-        std::upper_bound( sc.begin(), sc.end(), rand_range( sc.back() ) );
-    int i = std::distance( sc.begin(), aux );
-    return va[ i ];
+fluke::ProbalisticSelection::select( Agent **va, const double *sc, int n ) {
+    return pick( va, sc, n );
 }
-
@@ -51,6 +51,7 @@ fluke::ShortSeqManager::strShortSeq( label lbl ) const {
 void
 fluke::ShortSeqManager::allocShortSeq( label lbl ) {
     // allocate another instance of the int encoded sequence
+    boost::mutex::scoped_lock lock( ref_mutex_ );
 #ifdef DEBUG
     references_->at( lbl )++;
 #else
@@ -61,6 +62,7 @@ fluke::ShortSeqManager::allocShortSeq( label lbl ) {
 void
 fluke::ShortSeqManager::freeShortSeq( label lbl ) {
     // notify that int encoded sequence is no longer used
+    boost::mutex::scoped_lock lock( ref_mutex_ );
 #ifdef DEBUG
     references_->at( lbl )--;
 #else
@@ -129,6 +131,18 @@ fluke::ShortSeqManager::referenceCounts() const {
     return *references_;
 }
 
+std::size_t
+fluke::ShortSeqManager::bytes() const {
+    std::size_t result = sizeof( ShortSeqManager ) + 
+        sizeof( std::vector< std::string > ) + heap_bytes( *short_seqs_ ) + 
+        sizeof( std::vector< int > ) + heap_bytes( *references_ );
+    for( std::vector< std::string >::const_iterator i = short_seqs_->begin();
+        i != short_seqs_->end(); ++i ) {
+        result += i->capacity();
+    }
+    return result;
+}
+
 void 
 fluke::ShortSeqManager::generateShortSeqs() {
     // generate all the sequences, given the alphabet and the length
@@ -38,6 +38,10 @@ fluke::SimpleAgent::step( Population &pop ) {
     }
 }
 
+double
+fluke::SimpleAgent::mortality() const
+{ return death_rate_; }
+
 fluke::Agent*
 fluke::SimpleAgent::sibling() {
     Agent* result;
@@ -48,8 +52,9 @@ fluke::SimpleAgent::sibling() {
 
 void 
 fluke::SimpleAgent::write( std::ostream &os ) const {
-    os << "<agent birth=\"" << me_.time << "\" x=\"" << me_.x;
-    os << "\" y=\"" << me_.y << "\" i=\"" << me_.i << "\"";
+    AgentTag me = myTag();
+    os << "<agent birth=\"" << me.time << "\" x=\"" << me.x;
+    os << "\" y=\"" << me.y << "\" i=\"" << me.i << "\"";
     os << ">\n<class>SimpleAgent</class>\n</agent>\n";
 }
 
@@ -33,9 +33,9 @@ void
 fluke::SimpleNetwork::build( const Genome &g ) {
     // First gather all tf's and put them in the graph already.
     gene_net_map tf_map;
-    const std::list< Chromosome* > aux = g.chromosomes();
+    const Genome::chromos_container &aux = g.chromosomes();
     for( Genome::const_chromos_iter i = aux.begin(); i != aux.end(); ++i ) {
-        const std::list< ChromosomeElement* > bux = ( **i ).elements();
+        const Chromosome::ce_container &bux = ( **i ).elements();
         for( Chromosome::const_ce_iter j = bux.begin(); j != bux.end(); ++j ) {
             TranscriptionFactor *tf = 
                 dynamic_cast< TranscriptionFactor * >( *j );
@@ -50,7 +50,7 @@ fluke::SimpleNetwork::build( const Genome &g ) {
     // Second re-iterate the genome and for each bsite check if anything binds
     // to it... naive implementation, should be possible to make it faster!
     for( Genome::const_chromos_iter i = aux.begin(); i != aux.end(); ++i ) {
-        const std::list< ChromosomeElement* > bux = ( **i ).elements();
+        const Chromosome::ce_container &bux = ( **i ).elements();
         bool upstream = false;
         boolean_net::vertex_descriptor vux;
         for( Chromosome::const_ce_riter j = bux.rbegin();
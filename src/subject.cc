@@ -9,27 +9,27 @@
 #include "stream_manager.hh"
 
 void 
-fluke::Subject::attach( Observer *o ) {
+fluke::ObservedSubject::attach( Observer *o ) {
     obs_.push_back( o );
 }
 
 void 
-fluke::Subject::detach( Observer *o ) {
+fluke::ObservedSubject::detach( Observer *o ) {
     // observer 'o' exists in obs_
     obs_.erase( std::find( obs_.begin(), obs_.end(), o ) );
 }
 
 void 
-fluke::Subject::detachAll() {
+fluke::ObservedSubject::detachAll() {
     obs_.clear();
 }
 
 void 
-fluke::Subject::notify() 
+fluke::ObservedSubject::notify() 
 { notify( this ); }
 
 void
-fluke::Subject::notify( Subject *s ) {
+fluke::ObservedSubject::notify( Subject *s ) {
     for( obs_iter i = obs_.begin(); i != obs_.end(); ++i ) {
         ( **i ).update( s );
     }
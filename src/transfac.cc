@@ -13,7 +13,7 @@ fluke::ObjectCache< fluke::TranscriptionFactor >::instance_ = 0;
 
 
 fluke::TranscriptionFactor::TranscriptionFactor( 
-    const TranscriptionFactor &tp ) {
+    const TranscriptionFactor &tp ) : Downstream( TRANSCRIPTION_FACTOR ) {
     TranscriptionFactor::copy( tp );
 }
 
@@ -45,6 +45,14 @@ fluke::TranscriptionFactor::toPool() {
     ObjectCache< TranscriptionFactor >::instance()->returnObject( this );
 }
 
+void*
+fluke::TranscriptionFactor::operator new( std::size_t n ) 
+{ return ObjectCache< TranscriptionFactor >::instance()->allocate( n ); }
+
+void
+fluke::TranscriptionFactor::operator delete( void *p, std::size_t n ) 
+{ ObjectCache< TranscriptionFactor >::instance()->deallocate( p, n ); }
+
 int 
 fluke::TranscriptionFactor::mutate() {
     int result = 0;
@@ -56,6 +64,10 @@ void
 fluke::TranscriptionFactor::shortSeqManager( ShortSeqManager *s ) 
 { ssm_ = s; }
 
+fluke::ShortSeqManager*
+fluke::TranscriptionFactor::shortSeqManager() 
+{ return ssm_; }
+
 std::string 
 fluke::TranscriptionFactor::asXmlString() const {
     return "<transfac id=\"" + boost::lexical_cast< std::string >( tag_ ) + 